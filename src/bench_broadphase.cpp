@@ -0,0 +1,141 @@
+// Broadphase benchmark, runs headless (no window or GL context)
+//
+//     bench_broadphase [-monsters N] [-projectiles N] [-frames N]
+//
+// Moves N monsters and N projectiles around a map every frame and finds the
+// projectiles that overlap a monster, first by testing every projectile
+// against every monster and then with olc::SweepAndPrune. Reports the time
+// per frame for both along with how many pairs the broadphase tested and how
+// many of those overlapped. Projectiles only live for a second in the game,
+// so every frame a sixtieth of them is removed from the broadphase and added
+// again. Both have to find the same pairs, the benchmark fails if they don't.
+#define OLC_PGE_APPLICATION
+#include "olcPixelGameEngine.h"
+#include "olcPGEX_SweepAndPrune.h"
+#include <random>
+
+struct Options
+{
+    int monsters = 2000;
+    int projectiles = 2000;
+    int frames = 600;
+};
+
+enum Category { MONSTER = 1, PROJECTILE = 2 };
+
+struct Body
+{
+    olc::vf2d position;
+    olc::vf2d size;
+    olc::vf2d velocity;
+    int category;
+    uint32_t handle;
+};
+
+static bool Overlaps(const Body& a, const Body& b)
+{
+    return a.position.x + a.size.x > b.position.x && a.position.x < b.position.x + b.size.x &&
+        a.position.y + a.size.y > b.position.y && a.position.y < b.position.y + b.size.y;
+}
+
+int main(int argc, char* argv[])
+{
+    Options opt;
+    for (int i = 1; i < argc; i++)
+    {
+        std::string arg = argv[i];
+        if (arg == "-monsters" && i + 1 < argc) opt.monsters = std::max(1, atoi(argv[++i]));
+        else if (arg == "-projectiles" && i + 1 < argc) opt.projectiles = std::max(1, atoi(argv[++i]));
+        else if (arg == "-frames" && i + 1 < argc) opt.frames = std::max(1, atoi(argv[++i]));
+        else
+        {
+            std::cout << "Usage: bench_broadphase [-monsters N] [-projectiles N] [-frames N]" << std::endl;
+            return 1;
+        }
+    }
+
+    // Monsters walk at the player's speed and projectiles fly at twice that, on a map with room for all of them
+    float side = 32.0f * std::sqrt(float(opt.monsters + opt.projectiles) * 8.0f);
+    std::mt19937 rng(1);
+    std::uniform_real_distribution<float> where(0.0f, side);
+    std::uniform_real_distribution<float> heading(0.0f, 6.2831853f);
+    std::vector<Body> bodies;
+    for (int i = 0; i < opt.monsters + opt.projectiles; i++)
+    {
+        bool monster = i < opt.monsters;
+        float a = heading(rng), speed = monster ? 150.0f : 300.0f;
+        bodies.push_back({ { where(rng), where(rng) }, monster ? olc::vf2d(32.0f, 32.0f) : olc::vf2d(14.0f, 16.0f),
+            { std::cos(a) * speed, std::sin(a) * speed }, monster ? MONSTER : PROJECTILE, 0 });
+    }
+
+    auto step = [&](std::vector<Body>& moving)
+    {
+        for (auto& b : moving)
+        {
+            b.position += b.velocity / 60.0f;
+            if (b.position.x < 0.0f || b.position.x > side) b.velocity.x = -b.velocity.x;
+            if (b.position.y < 0.0f || b.position.y > side) b.velocity.y = -b.velocity.y;
+        }
+    };
+
+    // Pairs are kept as (monster, projectile) indices so both ways can be compared
+    using Pairs = std::vector<std::pair<int, int>>;
+    auto run = [&](const char* name, auto findPairs)
+    {
+        std::vector<Body> moving = bodies;
+        Pairs all;
+        size_t tested = 0, overlaps = 0;
+        auto tp = std::chrono::steady_clock::now();
+        for (int f = 0; f < opt.frames; f++)
+        {
+            step(moving);
+            findPairs(moving, all, tested, overlaps);
+        }
+        double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - tp).count() / opt.frames;
+        printf("    %-16s %10.4f ms/frame  %10.1f pairs tested  %6.2f overlapping\n", name, ms,
+            double(tested) / opt.frames, double(overlaps) / opt.frames);
+        std::sort(all.begin(), all.end());
+        return all;
+    };
+
+    std::cout << opt.monsters << " monsters, " << opt.projectiles << " projectiles, " << opt.frames << " frames" << std::endl;
+    Pairs expected = run("every pair", [&](std::vector<Body>& moving, Pairs& all, size_t& tested, size_t& overlaps)
+    {
+        for (int m = 0; m < opt.monsters; m++)
+            for (int p = opt.monsters; p < int(moving.size()); p++)
+            {
+                tested++;
+                if (Overlaps(moving[m], moving[p]))
+                {
+                    overlaps++;
+                    all.push_back({ m, p });
+                }
+            }
+    });
+
+    olc::SweepAndPrune<int> broadphase;
+    for (int i = 0; i < int(bodies.size()); i++)
+        bodies[i].handle = broadphase.Add(i, bodies[i].position, bodies[i].size, bodies[i].category,
+            bodies[i].category == MONSTER ? PROJECTILE : MONSTER);
+    int frame = 0;
+    Pairs found = run("sweep and prune", [&](std::vector<Body>& moving, Pairs& all, size_t& tested, size_t& overlaps)
+    {
+        int first = opt.monsters + frame++ % 60;
+        for (int p = first; p < int(moving.size()); p += 60)
+            broadphase.Remove(moving[p].handle);
+        for (int p = first; p < int(moving.size()); p += 60)
+            moving[p].handle = broadphase.Add(p, moving[p].position, moving[p].size, PROJECTILE, MONSTER);
+        for (auto& b : moving)
+            broadphase.Move(b.handle, b.position, b.size);
+        broadphase.FindPairs([&](int a, int b) { all.push_back({ std::min(a, b), std::max(a, b) }); });
+        tested += broadphase.PairsTested();
+        overlaps += broadphase.Overlaps();
+    });
+
+    if (found != expected)
+    {
+        std::cout << "Sweep and prune doesn't find the same pairs as testing every one" << std::endl;
+        return 1;
+    }
+    return 0;
+}
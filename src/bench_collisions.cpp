@@ -0,0 +1,312 @@
+// Collider filtering benchmark, runs headless (no window or GL context)
+//
+//     bench_collisions [-count N] [-queries N] [-frames N] [-sweep]
+//
+// Runs the collider checks of JinrisGame::CheckCollisions for N colliders,
+// once with the std::string tags the game used to compare ("map_terrain",
+// "collectable", "monster", "_destroyed_") and once with category bits and a
+// destroyed flag. Every frame does a number of queries like the player and
+// the projectile make, both over the whole collider list and over the cells
+// of an olc::SpatialHash around them, and reports the time per frame for
+// each. Tags and masks have to find the same colliders, the benchmark fails
+// if they don't.
+//
+// With -sweep it moves N boxes across random tile grids instead, once with
+// olc::SweepCells (what the game's SweepTiles does for projectiles) and once
+// in small substeps that test every cell under the box, and fails unless
+// SweepCells stops each box where the substeps say it can.
+#define OLC_PGE_APPLICATION
+#include "olcPixelGameEngine.h"
+#include "olcPGEX_SpatialHash.h"
+#include <random>
+
+struct Options
+{
+    int count = 20000;
+    int queries = 3;
+    int frames = 2000;
+    bool sweep = false;
+};
+
+enum ColliderCategory { CATEGORY_TERRAIN = 0, CATEGORY_COLLECTABLE, CATEGORY_MONSTER };
+static constexpr uint32_t COLLIDER_DESTROYED = uint32_t(1) << 31;
+static constexpr uint32_t CategoryMask(int category) { return uint32_t(1) << category; }
+
+struct TagCollider
+{
+    std::string tag;
+    olc::vf2d position;
+    olc::vf2d size;
+};
+
+struct MaskCollider
+{
+    uint32_t flags;
+    olc::vf2d position;
+    olc::vf2d size;
+};
+
+// Where the player and the projectile are for one check
+struct Query
+{
+    olc::vf2d player;
+    olc::vf2d projectile;
+    olc::vf2d projectileSize;
+};
+
+// What a check found, has to come out the same both ways
+struct Result
+{
+    int terrainHits = 0;
+    int collisions = 0;
+    int possible = 0;
+    bool operator==(const Result& r) const { return terrainHits == r.terrainHits && collisions == r.collisions && possible == r.possible; }
+};
+
+static bool Overlaps(const olc::vf2d& p, const olc::vf2d& ps, const olc::vf2d& o, const olc::vf2d& os)
+{
+    return p.x + ps.x > o.x && p.x < o.x + os.x && p.y + ps.y > o.y && p.y < o.y + os.y;
+}
+
+// The loop body as it was with string tags
+static void CheckTagged(const TagCollider& c, const Query& q, Result& r)
+{
+    if (c.tag == "map_terrain" && Overlaps(q.projectile, q.projectileSize, c.position, c.size))
+        r.terrainHits += 1;
+    if (std::abs(c.position.y - q.player.y) > 32.0f || std::abs(c.position.x - q.player.x) > 32.0f || c.tag == "_destroyed_")
+        return;
+    if (c.position.x == q.player.x && c.position.y == q.player.y &&
+        (c.tag == "collectable" || c.tag == "map_terrain" || c.tag == "monster"))
+        r.collisions += 1;
+    else
+        r.possible += 1;
+}
+
+// The same with category bits
+static void CheckMasked(const MaskCollider& c, const Query& q, Result& r)
+{
+    constexpr uint32_t terrain = CategoryMask(CATEGORY_TERRAIN);
+    constexpr uint32_t blocking = CategoryMask(CATEGORY_TERRAIN) | CategoryMask(CATEGORY_COLLECTABLE) | CategoryMask(CATEGORY_MONSTER);
+    if ((c.flags & (terrain | COLLIDER_DESTROYED)) == terrain && Overlaps(q.projectile, q.projectileSize, c.position, c.size))
+        r.terrainHits += 1;
+    if (std::abs(c.position.y - q.player.y) > 32.0f || std::abs(c.position.x - q.player.x) > 32.0f || (c.flags & COLLIDER_DESTROYED))
+        return;
+    if (c.position.x == q.player.x && c.position.y == q.player.y && (c.flags & blocking))
+        r.collisions += 1;
+    else
+        r.possible += 1;
+}
+
+struct SweptBox
+{
+    olc::vf2d position;
+    olc::vf2d size;
+    olc::vf2d step;
+};
+
+// When along the step a box can first touch a wall, found by moving it in small steps. The cells under
+// the box at either end of a substep and in between show the earliest it could, where a corner cuts
+// past a wall that can be a little early. The first time it is inside a wall shows the latest, that
+// misses corners cutting past a wall in less than a substep
+struct Contact
+{
+    float earliest = 1.0f;
+    float latest = 1.0f;
+};
+
+template<typename Func>
+static Contact Substep(const SweptBox& s, const olc::vf2d& tile, int substeps, Func wall)
+{
+    auto touches = [&](const olc::vf2d& min, const olc::vf2d& max)
+    {
+        for (int y = int(std::floor(min.y / tile.y)); y <= int(std::ceil(max.y / tile.y)) - 1; y++)
+            for (int x = int(std::floor(min.x / tile.x)); x <= int(std::ceil(max.x / tile.x)) - 1; x++)
+                if (wall({ x, y }))
+                    return true;
+        return false;
+    };
+
+    Contact c;
+    bool bEarliest = false;
+    for (int i = 0; i <= substeps; i++)
+    {
+        float t = float(i) / float(substeps);
+        olc::vf2d a = s.position + s.step * t;
+        if (touches(a, a + s.size))
+        {
+            c.earliest = bEarliest ? c.earliest : t;
+            c.latest = t;
+            return c;
+        }
+        olc::vf2d b = s.position + s.step * (float(i + 1) / float(substeps));
+        if (!bEarliest && i < substeps &&
+            touches({ std::min(a.x, b.x), std::min(a.y, b.y) }, olc::vf2d(std::max(a.x, b.x), std::max(a.y, b.y)) + s.size))
+        {
+            c.earliest = t;
+            bEarliest = true;
+        }
+    }
+    return c;
+}
+
+static int CheckSweeps(const Options& opt)
+{
+    // A map like the game's with a fifth of the cells walls, nothing outside it
+    const int side = 64;
+    const int substeps = 4096;
+    const olc::vf2d tile = { 32.0f, 32.0f };
+    std::mt19937 rng(1);
+    std::uniform_int_distribution<int> cell(0, side - 1);
+    std::uniform_int_distribution<int> kind(0, 99);
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+    std::vector<uint8_t> walls(side * side);
+    for (auto& w : walls)
+        w = kind(rng) < 20;
+    auto wall = [&](const olc::vi2d& c) { return c.x >= 0 && c.y >= 0 && c.x < side && c.y < side && walls[c.y * side + c.x]; };
+
+    // Half of them go straight along an axis from a spot on the grid, like the projectiles, the rest anywhere
+    std::vector<SweptBox> sweeps(opt.count);
+    for (auto& s : sweeps)
+    {
+        float length = unit(rng) * 8.0f * tile.x;
+        if (kind(rng) < 50)
+        {
+            s.position = olc::vf2d(float(cell(rng)), float(cell(rng))) * tile + olc::vf2d(1.0f, 0.0f);
+            s.size = { 14.0f, 16.0f };
+            s.step = kind(rng) < 50 ? olc::vf2d(kind(rng) < 50 ? length : -length, 0.0f) : olc::vf2d(0.0f, kind(rng) < 50 ? length : -length);
+        }
+        else
+        {
+            s.position = olc::vf2d(unit(rng), unit(rng)) * float(side) * tile;
+            s.size = olc::vf2d(1.0f + unit(rng) * 47.0f, 1.0f + unit(rng) * 47.0f);
+            float angle = unit(rng) * 6.2831853f;
+            s.step = olc::vf2d(std::cos(angle), std::sin(angle)) * length;
+        }
+    }
+
+    std::vector<float> swept(sweeps.size());
+    std::vector<Contact> stepped(sweeps.size());
+    auto run = [&](const char* name, auto& out, auto move)
+    {
+        auto tp = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < sweeps.size(); i++)
+            out[i] = move(sweeps[i]);
+        double us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - tp).count() / sweeps.size();
+        printf("    %-24s %10.4f us/box\n", name, us);
+    };
+
+    std::cout << opt.count << " boxes swept over a " << side << "x" << side << " grid" << std::endl;
+    run("SweepCells", swept, [&](const SweptBox& s) { return olc::SweepCells(s.position, s.size, s.step, tile, wall); });
+    run("substeps", stepped, [&](const SweptBox& s) { return Substep(s, tile, substeps, wall); });
+
+    // SweepCells has to stop the box between the two. Floats out there are about 1e-4 apart, the axis
+    // moving slowest can put that far off in time
+    int nMismatches = 0;
+    for (size_t i = 0; i < sweeps.size(); i++)
+    {
+        float t = swept[i];
+        Contact c = stepped[i];
+        olc::vf2d step = { std::abs(sweeps[i].step.x), std::abs(sweeps[i].step.y) };
+        float slowest = step.x == 0.0f ? step.y : step.y == 0.0f ? step.x : std::min(step.x, step.y);
+        float eps = 1e-3f / std::max(slowest, 1e-3f);
+        bool bAgree = c.earliest <= t + eps && t <= c.latest + eps;
+        if (!bAgree && nMismatches++ < 10)
+            printf("    box at (%g, %g) size (%g, %g) step (%g, %g): SweepCells %g, substeps %g to %g\n",
+                sweeps[i].position.x, sweeps[i].position.y, sweeps[i].size.x, sweeps[i].size.y,
+                sweeps[i].step.x, sweeps[i].step.y, t, c.earliest, c.latest);
+    }
+    if (nMismatches > 0)
+    {
+        std::cout << nMismatches << " boxes don't stop where the substeps do" << std::endl;
+        return 1;
+    }
+    return 0;
+}
+
+int main(int argc, char* argv[])
+{
+    Options opt;
+    for (int i = 1; i < argc; i++)
+    {
+        std::string arg = argv[i];
+        if (arg == "-count" && i + 1 < argc) opt.count = std::max(1, atoi(argv[++i]));
+        else if (arg == "-queries" && i + 1 < argc) opt.queries = std::max(1, atoi(argv[++i]));
+        else if (arg == "-frames" && i + 1 < argc) opt.frames = std::max(1, atoi(argv[++i]));
+        else if (arg == "-sweep") opt.sweep = true;
+        else
+        {
+            std::cout << "Usage: bench_collisions [-count N] [-queries N] [-frames N] [-sweep]" << std::endl;
+            return 1;
+        }
+    }
+    if (opt.sweep)
+        return CheckSweeps(opt);
+
+    // Tiles on a square map, mostly terrain with collectables, monsters and the odd destroyed one in between
+    int side = std::max(16, int(std::sqrt(opt.count * 2.0f)));
+    std::mt19937 rng(1);
+    std::uniform_int_distribution<int> cell(0, side - 1);
+    std::uniform_int_distribution<int> kind(0, 99);
+    std::vector<TagCollider> tagged(opt.count);
+    std::vector<MaskCollider> masked(opt.count);
+    olc::SpatialHash<const TagCollider> taggedGrid({ 32.0f, 32.0f });
+    olc::SpatialHash<const MaskCollider> maskedGrid({ 32.0f, 32.0f });
+    for (int i = 0; i < opt.count; i++)
+    {
+        olc::vf2d position = { float(cell(rng) * 32), float(cell(rng) * 32) };
+        int k = kind(rng);
+        int category = k < 60 ? CATEGORY_TERRAIN : k < 90 ? CATEGORY_COLLECTABLE : CATEGORY_MONSTER;
+        bool destroyed = kind(rng) < 5;
+
+        static const char* tags[] = { "map_terrain", "collectable", "monster" };
+        tagged[i] = { destroyed ? "_destroyed_" : tags[category], position, { 32.0f, 32.0f } };
+        masked[i] = { CategoryMask(category) | (destroyed ? COLLIDER_DESTROYED : 0), position, { 32.0f, 32.0f } };
+    }
+    for (int i = 0; i < opt.count; i++)
+    {
+        taggedGrid.Insert(&tagged[i], tagged[i].position, tagged[i].size);
+        maskedGrid.Insert(&masked[i], masked[i].position, masked[i].size);
+    }
+
+    std::vector<Query> queries(size_t(opt.queries) * opt.frames);
+    for (auto& q : queries)
+    {
+        q.player = { float(cell(rng) * 32), float(cell(rng) * 32) };
+        q.projectile = q.player + olc::vf2d(16.0f + kind(rng), 16.0f);
+        q.projectileSize = { 14.0f, 16.0f };
+    }
+
+    // The player looks at the cells around it and the projectile at the ones under it, like the game
+    auto query = [](const auto& grid, const Query& q, auto check)
+    {
+        grid.Query(q.player - olc::vf2d(32.0f, 32.0f), { 96.0f, 96.0f }, check);
+        grid.Query(q.projectile, q.projectileSize, check);
+    };
+
+    auto run = [&](const char* name, auto check)
+    {
+        Result result;
+        auto tp = std::chrono::steady_clock::now();
+        for (int f = 0; f < opt.frames; f++)
+            for (int i = 0; i < opt.queries; i++)
+                check(queries[size_t(f) * opt.queries + i], result);
+        double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - tp).count() / opt.frames;
+        printf("    %-24s %10.4f ms/frame\n", name, ms);
+        return result;
+    };
+
+    std::cout << opt.count << " colliders, " << opt.queries << " checks per frame, " << opt.frames << " frames" << std::endl;
+    Result listTags = run("all colliders, tags", [&](const Query& q, Result& r) { for (auto& c : tagged) CheckTagged(c, q, r); });
+    Result listMasks = run("all colliders, masks", [&](const Query& q, Result& r) { for (auto& c : masked) CheckMasked(c, q, r); });
+    Result gridTags = run("spatial hash, tags", [&](const Query& q, Result& r)
+        { query(taggedGrid, q, [&](const TagCollider* c) { CheckTagged(*c, q, r); }); });
+    Result gridMasks = run("spatial hash, masks", [&](const Query& q, Result& r)
+        { query(maskedGrid, q, [&](const MaskCollider* c) { CheckMasked(*c, q, r); }); });
+
+    if (!(listTags == listMasks) || !(gridTags == gridMasks))
+    {
+        std::cout << "Category masks don't find the same colliders as tags" << std::endl;
+        return 1;
+    }
+    return 0;
+}
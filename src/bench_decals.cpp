@@ -0,0 +1,110 @@
+// Decal submission benchmark, runs headless (no window or GL context)
+//
+//     bench_decals [-count N] [-frames N]
+//
+// Submits N regions of one decal per frame, first with a DrawPartialDecal call
+// for each and then with a single DrawPartialDecalBatch, and reports the time
+// per frame and per decal for both. The layer's decal list is cleared between
+// frames like the engine does, so its capacity carries over the same way.
+// Both paths have to produce the same DecalInstances, the benchmark fails if
+// they don't.
+#define OLC_PGE_APPLICATION
+#include "olcPixelGameEngine.h"
+#include <cstring>
+#include <random>
+
+struct Options
+{
+    int count = 1000;
+    int frames = 2000;
+};
+
+class DecalBench : public olc::PixelGameEngine
+{
+public:
+    bool OnUserCreate() override { return true; }
+    bool OnUserUpdate(float) override { return true; }
+
+    // Draws every item on its own, the way the game used to
+    void PerCall(olc::Decal* decal, const std::vector<olc::DecalBatchItem>& items)
+    {
+        for (auto& item : items)
+            DrawPartialDecal(item.pos, decal, item.source_pos, item.source_size, item.scale, item.tint);
+    }
+};
+
+int main(int argc, char* argv[])
+{
+    Options opt;
+    for (int i = 1; i < argc; i++)
+    {
+        std::string arg = argv[i];
+        if (arg == "-count" && i + 1 < argc) opt.count = std::max(1, atoi(argv[++i]));
+        else if (arg == "-frames" && i + 1 < argc) opt.frames = std::max(1, atoi(argv[++i]));
+        else
+        {
+            std::cout << "Usage: bench_decals [-count N] [-frames N]" << std::endl;
+            return 1;
+        }
+    }
+
+    // Only the screen size is needed, the layer is added by hand since there's no renderer to create its texture
+    DecalBench pge;
+    pge.Construct(1024, 832, 1, 1);
+    pge.GetLayers().emplace_back();
+    std::vector<olc::DecalInstance>& instances = pge.GetLayers()[0].vecDecalInstance;
+
+    // A decal without a sprite doesn't touch the renderer either, give it the UV scale of a 256x256 tilesheet
+    olc::Decal decal(nullptr);
+    decal.vUVScale = { 1.0f / 256.0f, 1.0f / 256.0f };
+
+    // Tiles on a grid with the odd tinted and scaled one, like the map and particles
+    std::mt19937 rng(1);
+    std::uniform_int_distribution<int> tile(0, 63);
+    std::vector<olc::DecalBatchItem> items(opt.count);
+    for (int i = 0; i < opt.count; i++)
+    {
+        int t = tile(rng);
+        items[i].pos = { float(i % 32) * 32.0f, float(i / 32 % 26) * 32.0f };
+        items[i].source_pos = { float(t % 8) * 32.0f, float(t / 8) * 32.0f };
+        items[i].source_size = { 32.0f, 32.0f };
+        if (i % 7 == 0)
+        {
+            items[i].scale = { 0.5f, 0.5f };
+            items[i].tint = olc::Pixel(255, 255, 255, uint8_t(i));
+        }
+    }
+
+    auto run = [&](const char* name, auto submit)
+    {
+        submit();
+        instances.clear();
+
+        auto tp = std::chrono::steady_clock::now();
+        for (int f = 0; f < opt.frames; f++)
+        {
+            submit();
+            instances.clear();
+        }
+        double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - tp).count() / opt.frames;
+        printf("    %-20s %10.4f ms/frame  %8.2f ns/decal\n", name, ms, ms * 1e6 / opt.count);
+    };
+
+    std::cout << opt.count << " decals per frame, " << opt.frames << " frames" << std::endl;
+    run("DrawPartialDecal", [&]() { pge.PerCall(&decal, items); });
+    run("DrawPartialDecalBatch", [&]() { pge.DrawPartialDecalBatch(&decal, items); });
+
+    // Both have to give the renderer exactly the same quads
+    pge.PerCall(&decal, items);
+    std::vector<olc::DecalInstance> expected = instances;
+    instances.clear();
+    pge.DrawPartialDecalBatch(&decal, items);
+    if (instances.size() != expected.size() ||
+        std::memcmp(instances.data(), expected.data(), expected.size() * sizeof(olc::DecalInstance)) != 0)
+    {
+        std::cout << "DrawPartialDecalBatch doesn't match DrawPartialDecal" << std::endl;
+        return 1;
+    }
+    instances.clear();
+    return 0;
+}
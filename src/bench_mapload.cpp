@@ -0,0 +1,332 @@
+// Map loading benchmark, runs headless (no window or GL context)
+//
+//     bench_mapload [-size N] [-layers N] [-colliders F] [-iterations N] [-jmap] [map]
+//
+// Without a map a synthetic one is generated: N x N tiles (64 up to 4096),
+// with a full ground layer, a Colliders layer where a fraction F of the cells
+// hold a tile, and sparse decoration, collectable and spawn marker layers.
+// Maps up to 1024x1024 are written as a Pyxel Edit JSON export, bigger ones
+// (or any size with -jmap) as a compiled .jmap since the JSON would run into
+// gigabytes.
+//
+// JSON maps are loaded by the DOM loader, the streaming (SAX) loader and the
+// parallel layer loader at 1, 2, 4 and 8 threads, .jmap maps by mapping them.
+// After parsing, the game's tiles and colliders are built for the whole map
+// through the chunk streamer. Parsing, chunk building, tile construction and
+// collider construction are timed separately, along with the number of heap
+// allocations in each and the peak RSS. Each loader runs in its own process
+// so the peak RSS numbers don't mix.
+#define OLC_PGE_APPLICATION
+#include "olcPixelGameEngine.h"
+#include "olcPGEX_PyxelMap.h"
+#include "olcPGEX_MapStreamer.h"
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include <unordered_map>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+// Count every heap allocation made through new
+static std::atomic<size_t> nAllocations{ 0 };
+static std::atomic<size_t> nAllocatedBytes{ 0 };
+
+// Every form of new and delete goes through this pair. Kept out of line so the compiler doesn't see
+// malloc and free meet the pointers of new and delete and warn they don't match
+[[gnu::noinline]] static void* Allocate(size_t size)
+{
+    nAllocations++;
+    nAllocatedBytes += size;
+    if (void* p = std::malloc(size ? size : 1))
+        return p;
+    throw std::bad_alloc();
+}
+
+[[gnu::noinline]] static void Release(void* p) noexcept { std::free(p); }
+
+void* operator new(size_t size) { return Allocate(size); }
+void* operator new[](size_t size) { return Allocate(size); }
+void operator delete(void* p) noexcept { Release(p); }
+void operator delete[](void* p) noexcept { Release(p); }
+void operator delete(void* p, size_t) noexcept { Release(p); }
+void operator delete[](void* p, size_t) noexcept { Release(p); }
+
+// Same as the game's, so constructing them costs the same
+enum ColliderCategory
+{
+    CATEGORY_TERRAIN = 0,
+    CATEGORY_COLLECTABLE,
+    CATEGORY_NONE = -1
+};
+static constexpr uint32_t CategoryMask(int category) { return uint32_t(1) << category; }
+
+struct mCollider
+{
+    uint32_t flags;
+    olc::vf2d position;
+    olc::vf2d size;
+    int64_t tile = -1;
+};
+
+static int LayerCategory(const std::string& layer)
+{
+    static const std::unordered_map<std::string, int> categories = {
+        { "Colliders", CATEGORY_TERRAIN },
+        { "Collectables", CATEGORY_COLLECTABLE } };
+    auto it = categories.find(layer);
+    return it == categories.end() ? CATEGORY_NONE : it->second;
+}
+
+struct Options
+{
+    int size = 100;
+    int layers = 8;
+    float colliders = 0.15f;
+    int iterations = 5;
+    bool jmap = false;
+    std::string file;
+};
+
+static const char* LayerName(int l)
+{
+    static const char* names[] = { "Layer 0", "Colliders", "Decoration", "Collectables", "Spawns" };
+    static std::string extra[64];
+    if (l < 5) return names[l];
+    if (extra[l % 64].empty()) extra[l % 64] = "Layer " + std::to_string(l);
+    return extra[l % 64].c_str();
+}
+
+// Tile id for a cell, deterministic so every run loads the same map
+static int SyntheticTile(int layer, int i, float colliders)
+{
+    uint32_t h = uint32_t(i) * 2654435761u ^ uint32_t(layer) * 40503u;
+    h ^= h >> 15;
+    float r = float(h % 10000) / 10000.0f;
+    switch (layer)
+    {
+    case 0: return 2 + int(h % 4);
+    case 1: return r < colliders ? 11 + int(h % 4) : -1;
+    default: return r < 0.05f ? 20 + layer + int(h % 8) : -1;
+    }
+}
+
+static void WriteSyntheticJson(const std::string& sFile, const Options& opt)
+{
+    const int width = opt.size, height = opt.size;
+
+    // Same shape as a Pyxel Edit export, every cell of every layer is written
+    std::ofstream o(sFile);
+    o << "{\n    \"tilewidth\": 32,\n    \"tileshigh\": " << height << ",\n    \"layers\": [\n";
+    for (int l = 0; l < opt.layers; l++)
+    {
+        o << "        {\n            \"number\": " << (opt.layers - 1 - l) << ",\n            \"tiles\": [\n";
+        for (int i = 0; i < width * height; i++)
+        {
+            o << "                {\n                    \"x\": " << (i % width) << ",\n                    \"flipX\": false,\n"
+              << "                    \"y\": " << (i / width) << ",\n                    \"index\": " << i << ",\n"
+              << "                    \"tile\": " << SyntheticTile(l, i, opt.colliders) << ",\n                    \"rot\": 0\n                }"
+              << (i + 1 < width * height ? ",\n" : "\n");
+        }
+        o << "            ],\n            \"name\": \"" << LayerName(l) << "\"\n        }"
+          << (l + 1 < opt.layers ? ",\n" : "\n");
+    }
+    o << "    ],\n    \"tileheight\": 32,\n    \"tileswide\": " << width << "\n}\n";
+}
+
+// PyxelMap only reads vLayers when saving, so the grids can live out here
+struct SyntheticMap : public olc::PyxelMap
+{
+    std::vector<std::vector<uint16_t>> grids;
+};
+
+static void WriteSyntheticJmap(const std::string& sFile, const Options& opt)
+{
+    SyntheticMap map;
+    map.vMapSize = { opt.size, opt.size };
+    map.vTileSize = { 32, 32 };
+    map.sTileSheet = "./sprites/tilesheet.png";
+    map.grids.resize(opt.layers);
+    for (int l = 0; l < opt.layers; l++)
+    {
+        map.grids[l].resize(size_t(opt.size) * opt.size);
+        for (size_t i = 0; i < map.grids[l].size(); i++)
+        {
+            int tile = SyntheticTile(l, int(i), opt.colliders);
+            map.grids[l][i] = tile < 0 ? olc::PyxelMap::EMPTY_TILE : uint16_t(tile);
+        }
+        map.vLayers.push_back({ LayerName(l), map.grids[l].data() });
+    }
+    map.SaveToBinary(sFile);
+}
+
+struct Phase
+{
+    double ms = 0.0;
+    size_t allocations = 0;
+    size_t bytes = 0;
+};
+
+struct Sample
+{
+    Phase parse, chunks, tiles, colliders;
+    size_t nTiles = 0;
+    size_t nColliders = 0;
+    size_t nLayers = 0;
+};
+
+// Build the game objects for the whole map the same way the game does for resident chunks
+static void BuildGameObjects(const olc::PyxelMap& map, Sample& sample)
+{
+    std::vector<std::vector<mCollider>> colliders;
+
+    auto count = [](Phase& phase, std::chrono::steady_clock::time_point tp, size_t allocations, size_t bytes)
+    {
+        phase.ms += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - tp).count();
+        phase.allocations += nAllocations - allocations;
+        phase.bytes += nAllocatedBytes - bytes;
+    };
+
+    // The game draws tiles straight from the map, all it keeps per tile is a bit for destroyed ones,
+    // and which layers make colliders
+    auto tp = std::chrono::steady_clock::now();
+    size_t allocations = nAllocations, bytes = nAllocatedBytes;
+    int64_t nCells = int64_t(map.vMapSize.x) * map.vMapSize.y;
+    std::vector<uint64_t> destroyed((map.vLayers.size() * nCells + 63) / 64, 0);
+    std::vector<int> layerCategory;
+    for (auto& layer : map.vLayers)
+        layerCategory.push_back(LayerCategory(layer.name));
+    count(sample.tiles, tp, allocations, bytes);
+
+    olc::MapStreamer streamer;
+    streamer.nResidencyRadius = 0;
+    streamer.nMemoryBudget = SIZE_MAX;
+    streamer.funcChunkLoaded = [&](const olc::MapStreamer::Chunk& chunk)
+    {
+        // Everything spent in here isn't chunk building, take it back out below
+        auto tp = std::chrono::steady_clock::now();
+        size_t allocations = nAllocations, bytes = nAllocatedBytes;
+
+        colliders.emplace_back();
+        for (auto& tile : chunk.vTiles)
+        {
+            int category = layerCategory[tile.layer];
+            if (category == CATEGORY_NONE)
+                continue;
+            olc::vf2d position = olc::vf2d(tile.vCell * map.vTileSize);
+            int64_t index = int64_t(tile.layer) * nCells + int64_t(tile.vCell.y) * map.vMapSize.x + tile.vCell.x;
+            colliders.back().push_back({ CategoryMask(category), position, map.vTileSize, index });
+        }
+        sample.nTiles += chunk.vTiles.size();
+        count(sample.colliders, tp, allocations, bytes);
+    };
+
+    tp = std::chrono::steady_clock::now();
+    allocations = nAllocations;
+    bytes = nAllocatedBytes;
+    streamer.Start(&map);
+    streamer.Update({ 0.0f, 0.0f }, olc::vf2d(map.vMapSize * map.vTileSize));
+    count(sample.chunks, tp, allocations, bytes);
+
+    sample.chunks.ms -= sample.colliders.ms;
+    sample.chunks.allocations -= sample.colliders.allocations;
+    sample.chunks.bytes -= sample.colliders.bytes;
+
+    for (auto& c : colliders) sample.nColliders += c.size();
+}
+
+// 0 threads is the DOM loader, -1 the single threaded SAX loader, -2 a mapped .jmap
+static void RunLoader(const std::string& sFile, int iterations, int threads)
+{
+    std::vector<Sample> samples;
+    for (int i = 0; i < iterations; i++)
+    {
+        Sample sample;
+        olc::PyxelMap map;
+
+        size_t allocations = nAllocations, bytes = nAllocatedBytes;
+        auto tp1 = std::chrono::steady_clock::now();
+        bool ok = threads == -2 ? map.LoadFromBinary(sFile)
+            : threads == 0 ? map.LoadFromJsonDom(sFile, "")
+            : threads < 0 ? map.LoadFromJson(sFile, "")
+            : map.LoadFromJsonParallel(sFile, "", threads);
+        auto tp2 = std::chrono::steady_clock::now();
+        if (!ok)
+        {
+            std::cout << "Failed to load " << sFile << std::endl;
+            exit(1);
+        }
+        sample.parse = { std::chrono::duration<double, std::milli>(tp2 - tp1).count(), nAllocations - allocations, nAllocatedBytes - bytes };
+        sample.nLayers = map.vLayers.size();
+
+        BuildGameObjects(map, sample);
+        samples.push_back(sample);
+    }
+
+    // Report the run with the fastest parse, the first one also pays for a cold page cache
+    const Sample& best = *std::min_element(samples.begin(), samples.end(),
+        [](const Sample& a, const Sample& b) { return a.parse.ms < b.parse.ms; });
+
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+
+    std::string name = threads == -2 ? "JMAP" : threads == 0 ? "DOM" : threads < 0 ? "SAX" : "SAX x" + std::to_string(threads);
+    auto phase = [](const char* label, const Phase& p)
+    {
+        printf("    %-10s %10.2f ms  %10zu allocs  %10.1f MB\n", label, p.ms, p.allocations, p.bytes / (1024.0 * 1024.0));
+    };
+    printf("%s  (%zu layers, %zu tiles, %zu colliders, peak RSS %ld KB)\n",
+        name.c_str(), best.nLayers, best.nTiles, best.nColliders, usage.ru_maxrss);
+    phase("parse", best.parse);
+    phase("chunks", best.chunks);
+    phase("tiles", best.tiles);
+    phase("colliders", best.colliders);
+}
+
+int main(int argc, char* argv[])
+{
+    Options opt;
+    for (int i = 1; i < argc; i++)
+    {
+        std::string arg = argv[i];
+        if (arg == "-size" && i + 1 < argc) opt.size = std::max(1, atoi(argv[++i]));
+        else if (arg == "-layers" && i + 1 < argc) opt.layers = std::max(2, atoi(argv[++i]));
+        else if (arg == "-colliders" && i + 1 < argc) opt.colliders = float(atof(argv[++i]));
+        else if (arg == "-iterations" && i + 1 < argc) opt.iterations = std::max(1, atoi(argv[++i]));
+        else if (arg == "-jmap") opt.jmap = true;
+        else if (arg[0] != '-') opt.file = arg;
+        else
+        {
+            std::cout << "Usage: bench_mapload [-size N] [-layers N] [-colliders F] [-iterations N] [-jmap] [map]" << std::endl;
+            return 1;
+        }
+    }
+
+    if (opt.file.empty())
+    {
+        opt.jmap = opt.jmap || opt.size > 1024;
+        opt.file = opt.jmap ? "./bench_map.jmap" : "./bench_map.json";
+        std::cout << "Generating " << opt.size << "x" << opt.size << ", " << opt.layers << " layers, "
+            << opt.colliders * 100.0f << "% colliders" << std::endl;
+        if (opt.jmap)
+            WriteSyntheticJmap(opt.file, opt);
+        else
+            WriteSyntheticJson(opt.file, opt);
+    }
+    else
+        opt.jmap = opt.file.size() >= 5 && opt.file.compare(opt.file.size() - 5, 5, ".jmap") == 0;
+
+    std::cout << opt.file << " (" << _gfs::file_size(opt.file) / 1024 << " KB), best of " << opt.iterations << " iterations" << std::endl;
+    std::vector<int> loaders = opt.jmap ? std::vector<int>{ -2 } : std::vector<int>{ 0, -1, 1, 2, 4, 8 };
+    for (int threads : loaders)
+    {
+        pid_t pid = fork();
+        if (pid == 0)
+        {
+            RunLoader(opt.file, opt.iterations, threads);
+            return 0;
+        }
+        waitpid(pid, nullptr, 0);
+    }
+    return 0;
+}
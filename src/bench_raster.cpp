@@ -0,0 +1,157 @@
+// Software rasterizer benchmark, runs headless (no window or GL context)
+//
+//     bench_raster [-count N] [-frames N]
+//
+// Draws N quads a frame into a 512x512 sprite with olc::SoftwareRasterizer,
+// through the scalar, SSE2 and AVX2 paths the CPU has, with nearest and with
+// bilinear sampling, and reports the time per frame for each. The quads are
+// spread over and past the edges of the target with random texture
+// coordinates. Most get a different w on every corner, the way
+// DrawWarpedDecal makes them or far apart, some are untextured and some are
+// tinted per corner.
+// Every path has to give exactly the same pixels as the scalar one, the
+// benchmark fails if it doesn't.
+#define OLC_PGE_APPLICATION
+#include "olcPixelGameEngine.h"
+#include <cstring>
+#include <random>
+
+struct Options
+{
+    int count = 20000;
+    int frames = 3;
+};
+
+// The w of every corner the way DrawWarpedDecal works it out, for corners given in NDC
+static void Warp(olc::DecalInstance& di)
+{
+    const olc::vf2d* pos = di.pos;
+    float rd = ((pos[2].x - pos[0].x) * (pos[3].y - pos[1].y) - (pos[3].x - pos[1].x) * (pos[2].y - pos[0].y));
+    if (rd == 0.0f)
+        return;
+    rd = 1.0f / rd;
+    float rn = ((pos[3].x - pos[1].x) * (pos[0].y - pos[1].y) - (pos[3].y - pos[1].y) * (pos[0].x - pos[1].x)) * rd;
+    float sn = ((pos[2].x - pos[0].x) * (pos[0].y - pos[1].y) - (pos[2].y - pos[0].y) * (pos[0].x - pos[1].x)) * rd;
+    olc::vf2d center;
+    if (!(rn < 0.f || rn > 1.f || sn < 0.f || sn > 1.f)) center = pos[0] + rn * (pos[2] - pos[0]);
+    float d[4]; for (int i = 0; i < 4; i++) d[i] = (pos[i] - center).mag();
+    for (int i = 0; i < 4; i++)
+    {
+        float q = d[i] == 0.0f ? 1.0f : (d[i] + d[(i + 2) & 3]) / d[(i + 2) & 3];
+        di.uv[i] *= q; di.w[i] *= q;
+    }
+}
+
+struct Quad
+{
+    olc::DecalInstance di;
+    bool textured;
+    bool vertexTint;
+};
+
+int main(int argc, char* argv[])
+{
+    Options opt;
+    for (int i = 1; i < argc; i++)
+    {
+        std::string arg = argv[i];
+        if (arg == "-count" && i + 1 < argc) opt.count = std::max(1, atoi(argv[++i]));
+        else if (arg == "-frames" && i + 1 < argc) opt.frames = std::max(1, atoi(argv[++i]));
+        else
+        {
+            std::cout << "Usage: bench_raster [-count N] [-frames N]" << std::endl;
+            return 1;
+        }
+    }
+
+    std::mt19937 rng(1);
+    std::uniform_int_distribution<int> byte(0, 255);
+    std::uniform_int_distribution<int> kind(0, 99);
+    std::uniform_real_distribution<float> where(-1.2f, 1.2f);
+    std::uniform_real_distribution<float> corner(-1.0f, 1.0f);
+    std::uniform_real_distribution<float> scale(-3.0f, -0.8f);
+    std::uniform_real_distribution<float> coord(-2.0f, 3.0f);
+
+    // An odd size so wrapping can't line up with powers of two
+    olc::SoftwareRasterizer::Texture texture;
+    texture.width = 37;
+    texture.height = 23;
+    texture.vPixels.resize(size_t(texture.width) * texture.height);
+    for (auto& p : texture.vPixels)
+        p = olc::Pixel(byte(rng), byte(rng), byte(rng), byte(rng));
+
+    std::vector<Quad> quads(opt.count);
+    for (auto& q : quads)
+    {
+        // From a few pixels across up to a sixth of the target, and slivers
+        olc::vf2d centre = { where(rng), where(rng) };
+        olc::vf2d extent = { std::pow(10.0f, scale(rng)), std::pow(10.0f, scale(rng)) };
+        for (int i = 0; i < 4; i++)
+        {
+            q.di.pos[i] = centre + olc::vf2d(corner(rng), corner(rng)) * extent;
+            q.di.uv[i] = { coord(rng), coord(rng) };
+            q.di.tint[i] = olc::Pixel(byte(rng), byte(rng), byte(rng), byte(rng));
+        }
+
+        // Texture coordinates are premultiplied by w. Far apart w take it close to zero
+        // just past the corners, where the texture coordinates run off to huge values
+        int k = kind(rng);
+        if (k < 50)
+            Warp(q.di);
+        else if (k < 70)
+            for (int i = 0; i < 4; i++)
+            {
+                q.di.w[i] = std::pow(10.0f, scale(rng) * 3.0f);
+                q.di.uv[i] *= q.di.w[i];
+            }
+        q.textured = kind(rng) < 85;
+        q.vertexTint = kind(rng) < 30;
+    }
+
+    olc::Sprite target(512, 512);
+    olc::SoftwareRasterizer raster;
+    raster.SetTarget(&target);
+
+    auto draw = [&](olc::SoftwareRasterizer::Sampling sampling)
+    {
+        std::fill(target.GetData(), target.GetData() + target.width * target.height, olc::Pixel(40, 40, 40));
+        for (auto& q : quads)
+            raster.DrawQuad(q.di, q.textured ? &texture : nullptr, q.vertexTint, sampling);
+        raster.Flush();
+    };
+
+    typedef olc::SoftwareRasterizer::Path Path;
+    typedef olc::SoftwareRasterizer::Sampling Sampling;
+    const char* paths[] = { "scalar", "sse2", "avx2" };
+    const char* samplings[] = { "nearest", "bilinear" };
+    bool bMatch = true;
+
+    std::cout << opt.count << " quads per frame, " << opt.frames << " frames" << std::endl;
+    for (Sampling sampling : { Sampling::NEAREST, Sampling::BILINEAR })
+    {
+        std::vector<olc::Pixel> expected;
+        for (Path path : { Path::SCALAR, Path::SSE2, Path::AVX2 })
+        {
+            raster.SetPath(path);
+            if (raster.GetPath() != path)
+                continue;
+
+            auto tp = std::chrono::steady_clock::now();
+            for (int f = 0; f < opt.frames; f++)
+                draw(sampling);
+            double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - tp).count() / opt.frames;
+            printf("    %-8s %-8s %10.4f ms/frame\n", paths[int(path)], samplings[int(sampling)], ms);
+
+            // The scalar path comes first, the others have to match it
+            if (path == Path::SCALAR)
+                expected.assign(target.GetData(), target.GetData() + target.width * target.height);
+            else if (std::memcmp(target.GetData(), expected.data(), expected.size() * sizeof(olc::Pixel)) != 0)
+            {
+                std::cout << "The " << paths[int(path)] << " path doesn't match the scalar one with "
+                    << samplings[int(sampling)] << " sampling" << std::endl;
+                bMatch = false;
+            }
+        }
+    }
+    return bMatch ? 0 : 1;
+}
@@ -0,0 +1,181 @@
+// Layer upload benchmark, runs headless through an EGL surfaceless context
+//
+//     EGL_PLATFORM=surfaceless bench_upload [-frames N] [-particles N]
+//
+// Draws into a 1024x832 layer on the CPU every frame and uploads it the three
+// ways the renderer can: the whole texture with glTexImage2D, the dirty regions
+// with glTexSubImage2D straight from the sprite, and the dirty regions through
+// the ring of pixel buffers, where a frame's regions are copied into the
+// texture on the next frame's update. Each frame draws the texture once so the upload
+// has to land before the next one starts, and glFinish is only called at the
+// end like a real frame loop that doesn't wait on the GPU. Besides the whole
+// frame, the time spent in the upload calls themselves is reported, that's
+// what the engine thread is blocked for. Run once with the
+// whole layer changing every frame and once with a few particles moving.
+// The texture is read back after each run, once the pixel buffers have
+// handed over the last frame, and has to match the sprite.
+#define OLC_PGE_APPLICATION
+#include "olcPixelGameEngine.h"
+#include <EGL/egl.h>
+#include <cstring>
+#include <random>
+
+struct Options
+{
+    int frames = 300;
+    int particles = 200;
+};
+
+class UploadBench : public olc::PixelGameEngine
+{
+public:
+    bool OnUserCreate() override { return true; }
+    bool OnUserUpdate(float) override { return true; }
+};
+
+int main(int argc, char* argv[])
+{
+    Options opt;
+    for (int i = 1; i < argc; i++)
+    {
+        std::string arg = argv[i];
+        if (arg == "-frames" && i + 1 < argc) opt.frames = std::max(1, atoi(argv[++i]));
+        else if (arg == "-particles" && i + 1 < argc) opt.particles = std::max(1, atoi(argv[++i]));
+        else
+        {
+            std::cout << "Usage: bench_upload [-frames N] [-particles N]" << std::endl;
+            return 1;
+        }
+    }
+
+    EGLDisplay display = eglGetDisplay(EGL_DEFAULT_DISPLAY);
+    EGLint nConfigs = 0;
+    EGLConfig config;
+    EGLint configAttribs[] = { EGL_SURFACE_TYPE, EGL_PBUFFER_BIT, EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT, EGL_NONE };
+    EGLint surfaceAttribs[] = { EGL_WIDTH, 1024, EGL_HEIGHT, 832, EGL_NONE };
+    if (!eglInitialize(display, nullptr, nullptr) || !eglChooseConfig(display, configAttribs, &config, 1, &nConfigs) || nConfigs == 0)
+    {
+        std::cout << "No EGL display, try EGL_PLATFORM=surfaceless" << std::endl;
+        return 1;
+    }
+    EGLSurface surface = eglCreatePbufferSurface(display, config, surfaceAttribs);
+    eglBindAPI(EGL_OPENGL_API);
+    EGLContext context = eglCreateContext(display, config, EGL_NO_CONTEXT, nullptr);
+    if (context == EGL_NO_CONTEXT || !eglMakeCurrent(display, surface, surface, context))
+    {
+        std::cout << "Couldn't create an OpenGL context" << std::endl;
+        return 1;
+    }
+    std::cout << (const char*)glGetString(GL_RENDERER) << ", OpenGL " << (const char*)glGetString(GL_VERSION) << std::endl;
+
+    // The engine creates the renderer, only the platform's window and context are skipped
+    UploadBench pge;
+    pge.Construct(1024, 832, 1, 1);
+    olc::Renderer* renderer = olc::renderer.get();
+    renderer->UpdateViewport({ 0, 0 }, { 1024, 832 });
+
+    olc::Sprite layer(1024, 832);
+    pge.SetDrawTarget(&layer);
+    std::vector<std::pair<olc::vi2d, olc::vi2d>> vRects;
+    std::vector<olc::Pixel> vReadback(layer.width * layer.height);
+
+    std::mt19937 rng(1);
+    std::uniform_real_distribution<float> pos(0.0f, 1024.0f), speed(20.0f, 50.0f);
+    struct Particle { float x, y, vy; };
+    std::vector<Particle> particles(opt.particles);
+    for (auto& p : particles)
+        p = { pos(rng), pos(rng), speed(rng) };
+
+    // Every pixel changes, like a layer that's redrawn from scratch
+    auto drawFull = [&](int f)
+    {
+        olc::Pixel* p = layer.GetData();
+        for (int y = 0; y < layer.height; y++)
+            for (int x = 0; x < layer.width; x++)
+                *p++ = olc::Pixel(uint8_t(x + f), uint8_t(y + f), uint8_t(x ^ y), 255);
+        layer.MarkDirty(0, 0, layer.width, layer.height);
+    };
+    // A few small things move, the rest stays
+    auto drawParticles = [&](int)
+    {
+        pge.Clear(olc::BLACK);
+        for (auto& p : particles)
+        {
+            if (p.y >= 832.0f) p.y = 0.0f;
+            pge.FillCircle(int32_t(p.x), int32_t(p.y), 4, olc::WHITE);
+            p.y += p.vy / 60.0f;
+        }
+    };
+
+    enum class Upload { Full, SubImage, PixelBuffers };
+    auto run = [&](const char* name, Upload mode, auto draw)
+    {
+        uint32_t tex = renderer->CreateTexture(layer.width, layer.height);
+        layer.SetDirtyTracking(false);
+        renderer->UpdateTexture(tex, &layer);
+        layer.SetDirtyTracking(true);
+        renderer->SetPixelBuffers(tex, mode == Upload::PixelBuffers);
+        // Draws the layer over the whole surface, the texture stays the run's to delete
+        olc::Decal decal(nullptr);
+        decal.id = tex;
+        decal.bOwnsTexture = false;
+
+        size_t nBytes = 0;
+        double dUploadMs = 0.0;
+        auto tp = std::chrono::steady_clock::now();
+        for (int f = 0; f < opt.frames; f++)
+        {
+            draw(f);
+            layer.TakeDirtyRects(vRects);
+            renderer->ApplyTexture(tex);
+            auto tpUpload = std::chrono::steady_clock::now();
+            if (mode == Upload::Full)
+            {
+                renderer->UpdateTexture(tex, &layer);
+                nBytes += size_t(layer.width) * layer.height * sizeof(olc::Pixel);
+            }
+            else
+            {
+                renderer->UpdateTextureRegions(tex, &layer, vRects);
+                for (auto& rect : vRects)
+                    nBytes += size_t(rect.second.x) * rect.second.y * sizeof(olc::Pixel);
+            }
+            dUploadMs += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - tpUpload).count();
+
+            olc::DecalInstance di;
+            di.decal = &decal;
+            di.pos[0] = { -1.0f, 1.0f }; di.pos[1] = { -1.0f, -1.0f }; di.pos[2] = { 1.0f, -1.0f }; di.pos[3] = { 1.0f, 1.0f };
+            renderer->PrepareDrawing();
+            renderer->DrawDecalQuad(di);
+            renderer->FlushDecalQuads();
+        }
+        glFinish();
+        double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - tp).count() / opt.frames;
+
+        renderer->ApplyTexture(tex);
+        renderer->UpdateTextureRegions(tex, &layer, {});
+        glGetTexImage(GL_TEXTURE_2D, 0, GL_RGBA, GL_UNSIGNED_BYTE, vReadback.data());
+        bool bMatches = std::memcmp(vReadback.data(), layer.GetData(), vReadback.size() * sizeof(olc::Pixel)) == 0;
+        renderer->DeleteTexture(tex);
+
+        printf("    %-16s %8.3f ms/frame  %8.3f ms uploading  %9.1f KB/frame%s\n", name, ms, dUploadMs / opt.frames, nBytes / 1024.0 / opt.frames, bMatches ? "" : "  TEXTURE DOESN'T MATCH");
+        return bMatches;
+    };
+
+    bool bOk = true;
+    std::cout << "Whole layer changing, " << opt.frames << " frames" << std::endl;
+    bOk &= run("glTexImage2D", Upload::Full, drawFull);
+    bOk &= run("glTexSubImage2D", Upload::SubImage, drawFull);
+    bOk &= run("pixel buffers", Upload::PixelBuffers, drawFull);
+    std::cout << opt.particles << " particles moving, " << opt.frames << " frames" << std::endl;
+    bOk &= run("glTexImage2D", Upload::Full, drawParticles);
+    bOk &= run("glTexSubImage2D", Upload::SubImage, drawParticles);
+    bOk &= run("pixel buffers", Upload::PixelBuffers, drawParticles);
+
+    olc::renderer.reset();
+    eglMakeCurrent(display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+    eglDestroyContext(display, context);
+    eglDestroySurface(display, surface);
+    eglTerminate(display);
+    return bOk ? 0 : 1;
+}
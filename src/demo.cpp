@@ -4,8 +4,18 @@
 #include "olcPGEX_AnimatedSprite.h"
 #include "olcPGEX_Camera2D.h"
 #include "olcPGEX_SplashScreen.h"
+#include "olcPGEX_PyxelMap.h"
+#include "olcPGEX_MapStreamer.h"
+#include "olcPGEX_Tileset.h"
+#include "olcPGEX_FileWatcher.h"
+#include "olcPGEX_Atlas.h"
+#include "olcPGEX_SpatialHash.h"
+#include "olcPGEX_SweepAndPrune.h"
 #include <random>
 #include <deque>
+#include <unordered_map>
+#include <future>
+#include <limits>
 #include "json.hpp"
 
 using json = nlohmann::json;
@@ -14,6 +24,7 @@ using json = nlohmann::json;
 #define WINDOW_WIDTH 1024
 #define M_PI 3.14159
 #define TILE_SIZE 32
+#define BAKED_CHUNK_SIZE 512
 #define SPEED 150
 #define FOV 15
 class JinrisGame : public olc::PixelGameEngine
@@ -48,6 +59,8 @@ private:
     std::uniform_int_distribution<> mRandomPlayerPos;
 
     bool bGameRunning;
+    // Shares its textures with the decals of the renderables it packs, so it's declared first to be destroyed last
+    olc::Atlas mAtlas;
     // Main menu background
     olc::Renderable mBackground;
 
@@ -92,22 +105,40 @@ private:
 
     std::deque<mParticle> mParticles;
 
-    struct mTile
+    // What a collider is, each category is one bit so a check can ask for several at once
+    enum ColliderCategory
     {
-        olc::vi2d position;
-        olc::vi2d tilesheetPos;
-        bool destroyed;
+        CATEGORY_TERRAIN = 0,
+        CATEGORY_COLLECTABLE,
+        CATEGORY_TILES,                     // The categories before this one are made from map layers
+        CATEGORY_MONSTER = CATEGORY_TILES,
+        CATEGORY_PLAYER,
+        CATEGORY_PROJECTILE,
+        CATEGORY_MONSTER_PROJECTILE,
+        CATEGORY_NONE = -1
+    };
+    static constexpr uint32_t COLLIDER_DESTROYED = uint32_t(1) << 31;
+    static constexpr uint32_t CategoryMask(int category) { return uint32_t(1) << category; }
+
+    // The colliders a check is interested in, it takes one of the included categories and none of the excluded flags
+    struct mColliderFilter
+    {
+        uint32_t include;
+        uint32_t exclude = COLLIDER_DESTROYED;
+        bool Matches(uint32_t flags) const { return (flags & include) != 0 && (flags & exclude) == 0; }
     };
 
     struct mCollider
     {
-        std::string tag;
+        uint32_t flags;     // CategoryMask of what it is, with COLLIDER_DESTROYED once it's gone
         olc::vf2d position;
         olc::vf2d size;
-        mTile* tile;
+        int64_t tile = -1;  // Bit in mDestroyedTiles of the map tile this collider belongs to, -1 for none
     };
 
     std::vector<mCollider*> mColliders;
+    // The same colliders by the tile they're on, collision checks only look at the ones nearby
+    olc::SpatialHash<mCollider> mColliderGrid{ { float(TILE_SIZE), float(TILE_SIZE) } };
     mCollider mPlayerCollider;
 
     struct mProjectile
@@ -117,6 +148,7 @@ private:
         olc::vf2d size;
         bool destroyed;
         std::string direction;
+        olc::vf2d step = { 0.0f, 0.0f };    // How far it moved in its last update
     };
 
     std::vector<mProjectile*> mProjectiles;
@@ -124,8 +156,26 @@ private:
     olc::Renderable mProjectileSprite;
     float mProjectileRotation = 0.0f;
 
-    olc::Renderable mSpriteSheet;
-    std::deque<mTile*> mTiles;
+    // Everything the game keeps for a resident map chunk
+    struct mMapChunk
+    {
+        std::vector<mCollider> colliders;
+        // All layers of the chunk flattened into one image, drawn as a single decal
+        std::unique_ptr<olc::Renderable> baked;
+        bool dirty = true;
+        int tiles = 0;
+        int hidden = 0;     // Tiles left out because an opaque tile above covers them
+    };
+
+    olc::Tileset mTileset;
+    std::unique_ptr<olc::PyxelMap> mMap;
+    std::string mMapFile;
+    olc::FileWatcher mMapWatcher;
+    olc::MapStreamer mMapStreamer;
+    // Keyed by olc::MapStreamer::Key, like the streamer's resident chunks
+    std::unordered_map<int64_t, mMapChunk> mMapChunks;
+    // One bit for every cell of every layer, in the same order as the map's tiles, set once the tile is destroyed
+    std::vector<uint64_t> mDestroyedTiles;
     int mMapSizeX;
     int mMapSizeY;
 
@@ -134,8 +184,13 @@ private:
 
     int mPossibleCollidables = 0;
     int mTilesDrawnOnMap = 0;
+    int mTilesHiddenOnMap = 0;
+    int mChunksDrawnOnMap = 0;
 
-    bool* mObstacleMap;
+    // One bit for every map cell and tile category, set while a tile of that category is there and not destroyed
+    std::vector<uint64_t> mObstacleMap[CATEGORY_TILES];
+    // The category of every map layer, looked up by name once per map
+    std::vector<int> mLayerCategory;
     int* mFlowFieldZ;
 
     struct mMonster
@@ -146,89 +201,475 @@ private:
 	olc::vi2d savedPlayerPos;
 	std::vector<mProjectile*> projectile;
 	mCollider* projectileCollider;
+        uint32_t body = 0;              // The monster and its projectile in mDynamicBodies
+        uint32_t projectileBody = 0;
     };
 
     std::vector<mMonster*> mMonsters;
 
+    // A moving collider as the broadphase knows it, with the monster it belongs to if any
+    struct mDynamicBody
+    {
+        int category;
+        mMonster* monster;
+    };
+
+    olc::SweepAndPrune<mDynamicBody> mDynamicBodies;
+    uint32_t mPlayerBody = 0;
+    uint32_t mProjectileBody = 0;
+
+    // Everything the loading thread produces, the decals are created from it on the engine thread
+    struct mLoadedAssets
+    {
+        std::unique_ptr<olc::PyxelMap> map;
+        std::string mapFile;
+        std::unique_ptr<olc::Sprite> tileSheet;
+        std::unique_ptr<olc::Sprite> background;
+        std::unique_ptr<olc::Sprite> character;
+        std::unique_ptr<olc::Sprite> projectile;
+    };
+
+    static constexpr int LOADING_STEPS = 5;
+    std::future<mLoadedAssets> mLoading;
+    std::atomic<int> mLoadingStep{ 0 };
+    bool mAssetsLoaded = false;
+
 
 public:
     JinrisGame() = default;
 
+    // Scripted runs need to know when the menu has been left
+    bool IsPlaying() const { return mGameState == GameState::GAME; }
+
 public:
 
-    // Pyxel json map parser
-    void LoadMap()
+    // Runs on the loading thread, nothing in here may touch the GPU
+    mLoadedAssets LoadAssets()
+    {
+        mLoadedAssets assets;
+        assets.map = LoadMap(assets.mapFile);
+        mLoadingStep++;
+        assets.tileSheet = LoadTileSheet(*assets.map);
+        mLoadingStep++;
+        assets.background = LoadSprite("./sprites/Logo.png");
+        mLoadingStep++;
+        assets.character = LoadSprite("./sprites/character.png");
+        mLoadingStep++;
+        assets.projectile = LoadSprite("./sprites/banana.png");
+        mLoadingStep++;
+        return assets;
+    }
+
+    // Runs on the engine thread once the loading thread is done, creates the decals
+    bool FinishLoading()
+    {
+#if defined(OLC_PGE_HEADLESS)
+        // Don't let the loader's timing decide how many frames the splash screen takes
+        if (mLoading.valid())
+            mLoading.wait();
+#endif
+        if (!mLoading.valid() || mLoading.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+            return false;
+
+        mLoadedAssets assets = mLoading.get();
+        mMap = std::move(assets.map);
+        mMapFile = assets.mapFile;
+        SetTileSheet(std::move(assets.tileSheet));
+        StartMapStreaming();
+
+        // Pick up edits to the map while the game is running
+        mMapWatcher.Watch(mMapFile);
+
+        mBackground.Create(std::move(assets.background));
+        spritesheet->Create(std::move(assets.character));
+        mProjectileSprite.Create(std::move(assets.projectile));
+
+        // Player, projectiles and the logo are drawn from one texture
+        mAtlas.Add(&mBackground);
+        mAtlas.Add(spritesheet);
+        mAtlas.Add(&mProjectileSprite);
+        mAtlas.Build();
+
+        mAssetsLoaded = true;
+        return true;
+    }
+
+    static std::unique_ptr<olc::Sprite> LoadSprite(const std::string& file)
+    {
+        auto sprite = std::make_unique<olc::Sprite>();
+        if (sprite->LoadFromFile(file) != olc::OK)
+            return nullptr;
+        return sprite;
+    }
+
+    // Pyxel map parser
+    static std::unique_ptr<olc::PyxelMap> LoadMap(std::string& mapFile)
+    {
+        // Shipping builds carry the compiled map, while authoring the Pyxel document is read directly
+        // A JSON export is only parsed when it changed since the last launch, see ./cache
+        auto map = std::make_unique<olc::PyxelMap>();
+        for (const char* file : { "./sprites/testing.jmap", "./sprites/map.pyxel", "./sprites/testing.json" })
+        {
+            if (map->LoadCached(file))
+            {
+                mapFile = file;
+                break;
+            }
+        }
+        return map;
+    }
+
+    static std::unique_ptr<olc::Sprite> LoadTileSheet(const olc::PyxelMap& map)
+    {
+        if (!map.HasArchiveTileSheet())
+            return LoadSprite(map.sTileSheet);
+
+        auto sheet = std::make_unique<olc::Sprite>(map.vTileSheetSize.x, map.vTileSheetSize.y);
+        map.BuildTileSheet(sheet.get());
+        return sheet;
+    }
+
+    void SetTileSheet(std::unique_ptr<olc::Sprite> sprite)
     {
         // This is not used by LoadMap, I only load the tilesheet here to access it later
         // Figured it was best placed here since it's map related
-        mSpriteSheet.Load("./sprites/tilesheet.png");
+        // Pyxel tile IDs start at 1 for the top left tile of the tilesheet
+        auto sheet = std::make_unique<olc::Renderable>();
+        sheet->Create(std::move(sprite));
+        mTileset.Clear();
+        mTileset.AddSheet(std::move(sheet), 1, mMap->vTileSize);
+
+        // Every chunk image was made from the old tilesheet
+        for (auto& chunk : mMapChunks)
+            chunk.second.dirty = true;
+    }
+
+    void DrawLoadingScreen()
+    {
+        Clear(olc::BLACK);
+
+        std::string text = "LOADING";
+        int barWidth = WINDOW_WIDTH / 2;
+        olc::vi2d barPos = { (WINDOW_WIDTH - barWidth) / 2, WINDOW_HEIGHT / 2 };
+        float progress = static_cast<float>(mLoadingStep) / LOADING_STEPS;
+
+        DrawStringDecal(olc::vf2d((WINDOW_WIDTH - GetTextSize(text).x * 4) * 0.5f, barPos.y - 48.0f), text, olc::Pixel(172, 83, 194), olc::vf2d(4.0f, 4.0f));
+        DrawRect(barPos, { barWidth, 16 }, olc::Pixel(175, 175, 175));
+        FillRect(barPos + olc::vi2d(2, 2), { static_cast<int>((barWidth - 3) * progress), 13 }, olc::Pixel(172, 83, 194));
+    }
 
-        std::ifstream i("./sprites/testing.json");
-        json j = json::parse(i);
+    void StartMapStreaming()
+    {
+        mMapSizeY = mMap->vMapSize.y;
+        mMapSizeX = mMap->vMapSize.x;
+        mDestroyedTiles.assign((mMap->vLayers.size() * mMapSizeX * mMapSizeY + 63) / 64, 0);
+        BuildObstacleMap();
+
+        // Spawns keep off the first column, on a map too narrow for that (or none at all) there's only 1 left
+        mRandomPlayerPos = std::uniform_int_distribution<>(1, std::max(1, mMapSizeX - 1));
+
+        // Chunks are baked into one image each, keep those at about BAKED_CHUNK_SIZE pixels
+        mMapStreamer.nChunkSize = std::max(1, BAKED_CHUNK_SIZE / std::max(mMap->vTileSize.x, mMap->vTileSize.y));
+
+        // Colliders are only created for the chunks around the camera, see OnChunkLoaded
+        mMapStreamer.nTileOverhead = sizeof(mCollider);
+        // Each resident chunk also holds its baked image, once in the sprite and once in the texture
+        olc::vi2d bakedSize = mMap->vTileSize * mMapStreamer.nChunkSize;
+        mMapStreamer.nChunkOverhead = size_t(bakedSize.x) * bakedSize.y * sizeof(olc::Pixel) * 2;
+        mMapStreamer.funcChunkLoaded = [&](const olc::MapStreamer::Chunk& chunk) { OnChunkLoaded(chunk); };
+        mMapStreamer.funcChunkEvicted = [&](const olc::MapStreamer::Chunk& chunk) { OnChunkEvicted(chunk); };
+        mMapStreamer.funcChunkPatched = [&](const olc::MapStreamer::Chunk& chunk, const std::vector<olc::PyxelMap::TileChange>& changes)
+            { OnChunkPatched(chunk, changes); };
+        mMapStreamer.Start(mMap.get());
+    }
 
-        mMapSizeY = j.at("tileshigh");
-        mMapSizeX = j.at("tileswide");
-        olc::vi2d tileSize = { j.at("tilewidth"), j.at("tileheight") };
+    // Called when the map file changes on disk
+    void ReloadMap()
+    {
+        auto tp1 = std::chrono::system_clock::now();
 
-        int tileSheetWidth = mSpriteSheet.Sprite()->width / tileSize.x;
+        // The file may not be completely written yet, if so the next change brings us back here
+        auto next = std::make_unique<olc::PyxelMap>();
+        if (!next->LoadCached(mMapFile))
+            return;
 
-        auto layers = j.at("layers");
+        auto tp2 = std::chrono::system_clock::now();
 
-        // Loop all the layers that we grab from the json file
-        for (auto& layer : layers)
+        std::vector<olc::PyxelMap::TileChange> changes;
+        if (mMap->Diff(*next, changes))
         {
-            // Loop each tile in the layer
-            for (auto& tile : layer.at("tiles"))
+            // Same size and layers, only the tiles that changed get touched
+            mMapStreamer.Patch(next.get(), changes);
+            mMap = std::move(next);
+            for (auto& change : changes)
             {
-                // This is the tile ID (position in the tilesheet / spritesheet) determined by Pyxel
-                int tileID = tile.at("tile");
-                // If tileID is -1 that means the tile has no tile aka is transparent
-                if (tileID != -1)
-                {
-                    std::string layerName = layer.at("name");
-                    int x = tile.at("x");
-                    int y = tile.at("y");
-                    x *= tileSize.x;
-                    y *= tileSize.y;
+                SetTileDestroyed(TileIndex(change.layer, change.cell), false);
+                UpdateObstacle(change.cell);
+            }
 
-                    int tileSheetPosY = 0;
-                    int tileSheetPosX = 0;
+            // Tiles may have been repainted in a .pyxel
+            if (mMap->HasArchiveTileSheet())
+                SetTileSheet(LoadTileSheet(*mMap));
+        }
+        else
+        {
+            // Anything else means starting over with the new map
+            for (auto& chunk : mMapStreamer.GetResident())
+                OnChunkEvicted(chunk.second);
+            mMapStreamer.Stop();
+            mMap = std::move(next);
+            SetTileSheet(LoadTileSheet(*mMap));
+            StartMapStreaming();
+        }
 
-                    // This is an easy way to know what Row in the tilesheet we want to grab the tile from
-                    if (tileID > tileSheetWidth)
-                    {
-                        int i = tileID;
-                        while (i > tileSheetWidth)
-                        {
-                            tileSheetPosY += 1;
-                            i -= tileSheetWidth;
-                        }
-                        tileSheetPosX = i - 1;
-                    }
-                    else
+        auto tp3 = std::chrono::system_clock::now();
+        std::cout << "Reloaded " << mMapFile << ": " << changes.size() << " tiles changed, load "
+            << std::chrono::duration<float, std::milli>(tp2 - tp1).count() << " ms, patch "
+            << std::chrono::duration<float, std::milli>(tp3 - tp2).count() << " ms" << std::endl;
+    }
+
+    size_t TileIndex(size_t layer, size_t cell) const { return layer * mMapSizeX * mMapSizeY + cell; }
+    bool IsTileDestroyed(size_t index) const { return (mDestroyedTiles[index >> 6] >> (index & 63)) & 1; }
+    void SetTileDestroyed(size_t index, bool destroyed)
+    {
+        uint64_t bit = uint64_t(1) << (index & 63);
+        if (((mDestroyedTiles[index >> 6] & bit) != 0) == destroyed)
+            return;
+        mDestroyedTiles[index >> 6] ^= bit;
+
+        // The chunk image still shows the old tile
+        size_t cell = index % (size_t(mMapSizeX) * mMapSizeY);
+        UpdateObstacle(cell);
+        int n = mMapStreamer.nChunkSize;
+        auto it = mMapChunks.find(olc::MapStreamer::Key(int(cell % mMapSizeX / n), int(cell / mMapSizeX / n)));
+        if (it != mMapChunks.end())
+            it->second.dirty = true;
+    }
+
+    // Pyxel layers that make colliders, by name
+    static int LayerCategory(const std::string& layer)
+    {
+        static const std::unordered_map<std::string, int> categories = {
+            { "Colliders", CATEGORY_TERRAIN },
+            { "Collectables", CATEGORY_COLLECTABLE } };
+        auto it = categories.find(layer);
+        return it == categories.end() ? CATEGORY_NONE : it->second;
+    }
+
+    // Covers the whole map, not just the chunks that are loaded
+    void BuildObstacleMap()
+    {
+        size_t cells = size_t(mMapSizeX) * mMapSizeY;
+        for (auto& bits : mObstacleMap)
+            bits.assign((cells + 63) / 64, 0);
+
+        mLayerCategory.clear();
+        for (size_t l = 0; l < mMap->vLayers.size(); l++)
+        {
+            int category = LayerCategory(mMap->vLayers[l].name);
+            mLayerCategory.push_back(category);
+            if (category == CATEGORY_NONE)
+                continue;
+
+            const uint16_t* tiles = mMap->vLayers[l].tiles;
+            std::vector<uint64_t>& bits = mObstacleMap[category];
+            for (size_t cell = 0; cell < cells; cell++)
+                if (tiles[cell] != olc::PyxelMap::EMPTY_TILE)
+                    bits[cell >> 6] |= uint64_t(1) << (cell & 63);
+        }
+    }
+
+    // Looks at every layer again, a cell can be covered by more than one of the same category
+    void UpdateObstacle(size_t cell)
+    {
+        if (mLayerCategory.empty())
+            return;
+
+        bool occupied[CATEGORY_TILES] = {};
+        for (size_t l = 0; l < mLayerCategory.size(); l++)
+        {
+            if (mLayerCategory[l] != CATEGORY_NONE && mMap->vLayers[l].tiles[cell] != olc::PyxelMap::EMPTY_TILE &&
+                !IsTileDestroyed(TileIndex(l, cell)))
+                occupied[mLayerCategory[l]] = true;
+        }
+
+        uint64_t bit = uint64_t(1) << (cell & 63);
+        for (int category = 0; category < CATEGORY_TILES; category++)
+        {
+            if (occupied[category])
+                mObstacleMap[category][cell >> 6] |= bit;
+            else
+                mObstacleMap[category][cell >> 6] &= ~bit;
+        }
+    }
+
+    // True if a tile of any category in the mask is on the cell
+    bool IsObstacle(uint32_t mask, olc::vi2d cell) const
+    {
+        if (cell.x < 0 || cell.y < 0 || cell.x >= mMapSizeX || cell.y >= mMapSizeY)
+            return false;
+        size_t index = size_t(cell.y) * mMapSizeX + cell.x;
+        for (int category = 0; category < CATEGORY_TILES; category++)
+            if ((mask & CategoryMask(category)) && ((mObstacleMap[category][index >> 6] >> (index & 63)) & 1))
+                return true;
+        return false;
+    }
+
+    // Flatten every layer of a chunk into its image, only done again once a tile in it changes
+    void BakeChunk(const olc::vi2d& vChunk, mMapChunk& chunk)
+    {
+        int n = mMapStreamer.nChunkSize;
+        olc::vi2d tileSize = mMap->vTileSize;
+        if (!chunk.baked)
+        {
+            chunk.baked = std::make_unique<olc::Renderable>();
+            chunk.baked->Create(n * tileSize.x, n * tileSize.y);
+        }
+        olc::Sprite* target = chunk.baked->Sprite();
+        std::fill(target->GetData(), target->GetData() + target->width * target->height, olc::BLANK);
+
+        olc::vi2d first = vChunk * n;
+        olc::vi2d last = { std::min(first.x + n, mMapSizeX), std::min(first.y + n, mMapSizeY) };
+
+        // Empty cells, destroyed tiles and ids without a tilesheet are not rendered
+        auto visibleTile = [&](size_t l, size_t cell) -> const olc::Tileset::Region*
+        {
+            uint16_t id = mMap->vLayers[l].tiles[cell];
+            if (id == olc::PyxelMap::EMPTY_TILE || IsTileDestroyed(TileIndex(l, cell)))
+                return nullptr;
+            const olc::Tileset::Region& region = mTileset.GetRegion(id);
+            return region.nSheet == olc::Tileset::NO_SHEET ? nullptr : &region;
+        };
+
+        // Nothing under the topmost opaque tile of a cell shows, start drawing that cell from there
+        std::vector<uint16_t> lowestLayer(size_t(n) * n, 0);
+        for (size_t l = 1; l < mMap->vLayers.size(); l++)
+            for (int y = first.y; y < last.y; y++)
+                for (int x = first.x; x < last.x; x++)
+                {
+                    const olc::Tileset::Region* region = visibleTile(l, size_t(y) * mMapSizeX + x);
+                    if (region != nullptr && region->bOpaque)
+                        lowestLayer[(y - first.y) * n + (x - first.x)] = uint16_t(l);
+                }
+
+        chunk.tiles = 0;
+        chunk.hidden = 0;
+        for (size_t l = 0; l < mMap->vLayers.size(); l++)
+        {
+            for (int y = first.y; y < last.y; y++)
+            {
+                size_t row = size_t(y) * mMapSizeX;
+                for (int x = first.x; x < last.x; x++)
+                {
+                    const olc::Tileset::Region* region = visibleTile(l, row + x);
+                    if (region == nullptr)
+                        continue;
+                    if (l < lowestLayer[(y - first.y) * n + (x - first.x)])
                     {
-                        tileSheetPosX = tileID - 1;
+                        chunk.hidden += 1;
+                        continue;
                     }
 
-                    // Make sure we grab just 1 tile / sprite
-                    tileSheetPosY *= tileSize.y;
-                    tileSheetPosX *= tileSize.x;
+                    BlendTile(target, (olc::vi2d(x, y) - first) * tileSize, mTileset.GetSheet(region->nSheet)->Sprite(), *region);
+                    chunk.tiles += 1;
+                }
+            }
+        }
 
-                    // Here we store all tile values into a vector of tiles
-                    // The data we store is basically the position on the map where it's drawn
-                    // and also the position on the tileSheet where it's stored
-                    mTiles.push_back(new mTile{ { x, y }, { tileSheetPosX, tileSheetPosY }, false });
+        chunk.baked->Decal()->Update();
+        chunk.dirty = false;
+    }
 
-                    // Used for my own collisions, ignore this (Credits to Witty bits for the collision struct from the relay race)
-                    if (layerName == "Colliders")
-                        mColliders.push_back(new mCollider{ "map_terrain", { static_cast<float>(x), static_cast<float>(y) }, tileSize, mTiles.back() });
-                    if (layerName == "Collectables")
-                        mColliders.push_back(new mCollider{ "collectable", { static_cast<float>(x), static_cast<float>(y) }, tileSize, mTiles.back() });
+    // Draws a tile over what the lower layers left in the image, "over" blending including the alpha
+    static void BlendTile(olc::Sprite* target, const olc::vi2d& position, olc::Sprite* sheet, const olc::Tileset::Region& region)
+    {
+        for (int y = 0; y < region.vSize.y; y++)
+        {
+            const olc::Pixel* src = sheet->GetData() + (region.vPos.y + y) * sheet->width + region.vPos.x;
+            olc::Pixel* dst = target->GetData() + (position.y + y) * target->width + position.x;
+            if (region.bOpaque)
+            {
+                std::copy(src, src + region.vSize.x, dst);
+                continue;
+            }
+            for (int x = 0; x < region.vSize.x; x++)
+            {
+                if (src[x].a == 255 || dst[x].a == 0)
+                    dst[x] = src[x];
+                else if (src[x].a != 0)
+                {
+                    int sa = src[x].a, da = dst[x].a * (255 - sa) / 255, a = sa + da;
+                    dst[x] = olc::Pixel(
+                        uint8_t((src[x].r * sa + dst[x].r * da) / a),
+                        uint8_t((src[x].g * sa + dst[x].g * da) / a),
+                        uint8_t((src[x].b * sa + dst[x].b * da) / a),
+                        uint8_t(a));
                 }
             }
         }
     }
 
+    void OnChunkLoaded(const olc::MapStreamer::Chunk& chunk)
+    {
+        olc::vi2d tileSize = mMap->vTileSize;
+        mMapChunk& mapChunk = mMapChunks[olc::MapStreamer::Key(chunk.vChunk.x, chunk.vChunk.y)];
+
+        // Used for my own collisions, ignore this (Credits to Witty bits for the collision struct from the relay race)
+        for (auto& tile : chunk.vTiles)
+        {
+            int category = mLayerCategory[tile.layer];
+            if (category == CATEGORY_NONE)
+                continue;
+            olc::vf2d position = olc::vf2d(tile.vCell * tileSize);
+            int64_t index = TileIndex(tile.layer, size_t(tile.vCell.y) * mMapSizeX + tile.vCell.x);
+            mapChunk.colliders.push_back({ CategoryMask(category), position, tileSize, index });
+        }
+        for (auto& c : mapChunk.colliders)
+        {
+            mColliders.push_back(&c);
+            mColliderGrid.Insert(&c, c.position, c.size);
+        }
+    }
+
+    void OnChunkPatched(const olc::MapStreamer::Chunk& chunk, const std::vector<olc::PyxelMap::TileChange>& changes)
+    {
+        auto it = mMapChunks.find(olc::MapStreamer::Key(chunk.vChunk.x, chunk.vChunk.y));
+        if (it == mMapChunks.end())
+            return;
+        it->second.dirty = true;
+
+        // Only adding or removing a tile changes which colliders exist, rebuild the chunk for that
+        for (auto& change : changes)
+        {
+            if (change.from == olc::PyxelMap::EMPTY_TILE || change.to == olc::PyxelMap::EMPTY_TILE)
+            {
+                OnChunkEvicted(chunk);
+                OnChunkLoaded(chunk);
+                return;
+            }
+        }
+    }
+
+    void OnChunkEvicted(const olc::MapStreamer::Chunk& chunk)
+    {
+        auto it = mMapChunks.find(olc::MapStreamer::Key(chunk.vChunk.x, chunk.vChunk.y));
+        if (it == mMapChunks.end())
+            return;
+
+        // Drop the chunk's colliders before the chunk itself
+        std::vector<mCollider>& colliders = it->second.colliders;
+        if (!colliders.empty())
+        {
+            const mCollider* first = colliders.data();
+            const mCollider* last = colliders.data() + colliders.size();
+            mColliders.erase(std::remove_if(mColliders.begin(), mColliders.end(),
+                [&](mCollider* c) { return c >= first && c < last; }), mColliders.end());
+            for (auto& c : colliders)
+                mColliderGrid.Remove(&c);
+        }
+        mMapChunks.erase(it);
+    }
+
     bool OnUserCreate() override
     {
         // Set window title
@@ -236,14 +677,19 @@ public:
 
         bGameRunning = true;
 
-        LoadMap();
+        // Levels and sprites are read on a worker while the splash screen plays
+        mLoading = std::async(std::launch::async, [this]() { return LoadAssets(); });
 
         // Initialize Random generator
+#if defined(OLC_PGE_HEADLESS)
+        // Headless runs have to play out the same way every time
+        gen = std::mt19937(1);
+#else
         gen = std::mt19937(rd());
+#endif
         PosDistr = std::uniform_int_distribution<>(0, WINDOW_WIDTH);
         SpdDistr = std::uniform_int_distribution<>(20, 50);
         EnmDistr = std::uniform_int_distribution<>(-10, 10);
-        mRandomPlayerPos = std::uniform_int_distribution<>(1, mMapSizeX - 1);
 
         // Setup menu options
         mMenuTitle = "JINRI'S ADVENTURE";
@@ -271,17 +717,12 @@ public:
             mParticles.emplace_back(p);
         }
 
-        // Create the background image for menu
-        mBackground.Load("./sprites/logo.png");
-
         // Initialize our main player along side all sprites for main player
         player = { 0, 0, false, false, 0, 0, 100 };
-        mPlayerCollider = { "player", { player.x, player.y }, { static_cast<float>(TILE_SIZE), static_cast<float>(TILE_SIZE) } };
+        mPlayerCollider = { CategoryMask(CATEGORY_PLAYER), { player.x, player.y }, { static_cast<float>(TILE_SIZE), static_cast<float>(TILE_SIZE) } };
         PlayerSprite.type = olc::AnimatedSprite::SPRITE_TYPE::DECAL;
         PlayerSprite.mode = olc::AnimatedSprite::SPRITE_MODE::SINGLE;
         spritesheet = new olc::Renderable();
-
-        spritesheet->Load("./sprites/character.png");
         PlayerSprite.spriteSheet = spritesheet;
         PlayerSprite.SetSpriteSize({ 32, 32 });
 
@@ -298,17 +739,22 @@ public:
         // Set players default state
         PlayerSprite.SetState("idle-down");
 
-        // Load sprite for the projectile
-        mProjectileSprite.Load("./sprites/banana.png");
-
         // Create Monsters
         for (int i = 0; i < 10; i++)
         {
             float x = SpdDistr(gen);
             float y = SpdDistr(gen);
-            mColliders.push_back(new mCollider{ "monster", { x * TILE_SIZE, y * TILE_SIZE }, { TILE_SIZE, TILE_SIZE } });
+            mColliders.push_back(new mCollider{ CategoryMask(CATEGORY_MONSTER), { x * TILE_SIZE, y * TILE_SIZE }, { TILE_SIZE, TILE_SIZE } });
             mMonsters.push_back(new mMonster{ { x, y }, 100,  mColliders.back(), { player.nX, player.nY }, { } });
+            mColliderGrid.Insert(mColliders.back(), mColliders.back()->position, mColliders.back()->size);
+
+            // Nothing collides with the projectile until it's fired, HandleDynamicCollisions keeps these up to date
+            mMonster* monster = mMonsters.back();
+            monster->body = mDynamicBodies.Add({ CATEGORY_MONSTER, monster }, monster->collider->position, monster->collider->size, 0, 0);
+            monster->projectileBody = mDynamicBodies.Add({ CATEGORY_MONSTER_PROJECTILE, monster }, { 0.0f, 0.0f }, { 0.0f, 0.0f }, 0, 0);
         }
+        mPlayerBody = mDynamicBodies.Add({ CATEGORY_PLAYER, nullptr }, mPlayerCollider.position, mPlayerCollider.size, 0, 0);
+        mProjectileBody = mDynamicBodies.Add({ CATEGORY_PROJECTILE, nullptr }, { 0.0f, 0.0f }, { 0.0f, 0.0f }, 0, 0);
 
         // Set Camera position
         camera.InitialiseCamera(olc::vf2d(player.x, player.y) - (camera.vecCamViewSize * 0.5), { WINDOW_WIDTH, WINDOW_HEIGHT });
@@ -316,6 +762,8 @@ public:
 
         // Create all of our layers
         mLayerParticle = CreateLayer();
+        // Particles can show up a frame late, the driver copies them in while the next frame is drawn
+        SetLayerPixelBuffers(mLayerParticle, true);
 
         return true;
     }
@@ -476,74 +924,135 @@ public:
 
     }
 
-    bool CheckMonsterCollision(mMonster* monster)
+    // Same as CheckProjectileCollision for every point on p's way from its position to position + step
+    bool CheckSweptCollision(const mCollider& p, const olc::vf2d& step, const mCollider& o)
     {
-        if (monster->collider->tag == "_destroyed_")
-            return false;
-        if (!mProjectiles.empty() && CheckProjectileCollision(mProjectileCollider, *(monster->collider)))
+        // p touches o while its corner is inside o grown by p's size, find when that is on each axis
+        float enter = 0.0f, exit = 1.0f;
+        auto axis = [&](float from, float move, float min, float max)
         {
-            monster->health -= 50;
-            if (monster->health <= 0)
-                monster->collider->tag = "_destroyed_";
+            if (move == 0.0f)
+            {
+                if (from <= min || from >= max)
+                    exit = -1.0f;
+                return;
+            }
+            float t0 = (min - from) / move, t1 = (max - from) / move;
+            enter = std::max(enter, std::min(t0, t1));
+            exit = std::min(exit, std::max(t0, t1));
+        };
+        axis(p.position.x, step.x, o.position.x - p.size.x, o.position.x + o.size.x);
+        axis(p.position.y, step.y, o.position.y - p.size.y, o.position.y + o.size.y);
+        return enter < exit;
+    }
 
-            mProjectiles.pop_back();
-            return true;
-        }
-	if (!monster->projectile.empty() && CheckProjectileCollision(mPlayerCollider, *(monster->projectileCollider)))
-	{
-	    player.health -= 5;
-	    DeleteMonsterProjectile(monster);
-	    return true;
-	}
-        return false;
+    // Walks the map cells a box passes on its way from position to position + step, in the order it gets to them,
+    // using the obstacle map rather than colliders. Returns how much of the step it made before touching a tile of
+    // a category in the mask, 1 if it got all the way
+    float SweepTiles(const olc::vf2d& position, const olc::vf2d& size, const olc::vf2d& step, uint32_t mask) const
+    {
+        return olc::SweepCells(position, size, step, olc::vf2d(mMap->vTileSize),
+            [&](const olc::vi2d& cell) { return IsObstacle(mask, cell); });
     }
 
-    bool CheckCollisions()
+    // Moving things are only tested against each other, the broadphase hands over the pairs that overlap
+    void HandleDynamicCollisions()
     {
-        mPossibleCollidables = 0;
-        for (auto* c : mColliders)
+        // Projectiles take up the whole way they moved in their last update, so a long frame can't make them miss
+        auto sync = [&](uint32_t body, const mCollider* c, bool active, uint32_t collidesWith, olc::vf2d step = { 0.0f, 0.0f })
         {
-            // Only check collisions if there is a projectile
-            if (!mProjectiles.empty())
+            if (!active || c == nullptr || (c->flags & COLLIDER_DESTROYED))
             {
-                if (CheckProjectileCollision(mProjectileCollider, *c))
-                {
-                    if (c->tag == "map_terrain")
-                    {
-                        mProjectiles.pop_back();
-                    }
-                }
+                mDynamicBodies.SetFilter(body, 0, 0);
+                return;
             }
-            // only check collision on collidables within a tile from the player
-            if (std::abs(c->position.y - player.nY) > TILE_SIZE ||
-                std::abs(c->position.x - player.nX) > TILE_SIZE ||
-                c->tag == "_destroyed_")
-                continue;
-            if (CheckPositionalCollision(mPlayerCollider, *c))
+            olc::vf2d from = { std::min(c->position.x, c->position.x + step.x), std::min(c->position.y, c->position.y + step.y) };
+            mDynamicBodies.Move(body, from, c->size + olc::vf2d(std::abs(step.x), std::abs(step.y)));
+            mDynamicBodies.SetFilter(body, c->flags, collidesWith);
+        };
+
+        // The player's projectile collider is where its last step started, a monster's where it ended
+        sync(mPlayerBody, &mPlayerCollider, true, CategoryMask(CATEGORY_MONSTER_PROJECTILE));
+        sync(mProjectileBody, &mProjectileCollider, !mProjectiles.empty(), CategoryMask(CATEGORY_MONSTER),
+            mProjectiles.empty() ? olc::vf2d(0.0f, 0.0f) : mProjectiles.back()->step);
+        for (auto* monster : mMonsters)
+        {
+            bool alive = !(monster->collider->flags & COLLIDER_DESTROYED);
+            bool firing = alive && !monster->projectile.empty();
+            sync(monster->body, monster->collider, alive, CategoryMask(CATEGORY_PROJECTILE));
+            sync(monster->projectileBody, monster->projectileCollider, firing, CategoryMask(CATEGORY_PLAYER),
+                firing ? monster->projectile.back()->step * -1.0f : olc::vf2d(0.0f, 0.0f));
+        }
+
+        mDynamicBodies.FindPairs([&](mDynamicBody& a, mDynamicBody& b)
+        {
+            mDynamicBody* first = &a;
+            mDynamicBody* second = &b;
+            if (second->category < first->category)
+                std::swap(first, second);
+
+            if (first->category == CATEGORY_MONSTER && second->category == CATEGORY_PROJECTILE)
             {
-                if (c->tag == "collectable")
-                {
-                    return true;
-                }
-                else if (c->tag == "map_terrain")
-                {
-                    return true;
-                }
+                // The projectile is gone after the first monster it hits
+                mMonster* monster = first->monster;
+                if (mProjectiles.empty() || (monster->collider->flags & COLLIDER_DESTROYED) ||
+                    !CheckSweptCollision(mProjectileCollider, mProjectiles.back()->step, *monster->collider))
+                    return;
+                monster->health -= 50;
+                if (monster->health <= 0)
+                    monster->collider->flags |= COLLIDER_DESTROYED;
+                mProjectiles.pop_back();
             }
-            if (c->tag == "monster" && CheckPositionalCollision(mPlayerCollider, *c))
+            else if (first->category == CATEGORY_PLAYER && second->category == CATEGORY_MONSTER_PROJECTILE)
             {
-                return true;
+                // Swept backwards from where it is now to where the step started
+                mMonster* monster = second->monster;
+                if (monster->projectile.empty() ||
+                    !CheckSweptCollision(*monster->projectileCollider, monster->projectile.back()->step * -1.0f, mPlayerCollider))
+                    return;
+                player.health -= 5;
+                DeleteMonsterProjectile(monster);
+            }
+        });
+    }
+
+    bool CheckCollisions()
+    {
+        // Map tiles can't move, every cell the player would overlap tells if there's one in the way
+        const uint32_t tiles = CategoryMask(CATEGORY_TERRAIN) | CategoryMask(CATEGORY_COLLECTABLE);
+        olc::vf2d tile = olc::vf2d(mMap->vTileSize);
+        olc::vf2d min = mPlayerCollider.position, max = mPlayerCollider.position + mPlayerCollider.size;
+        olc::vi2d first = { int(std::floor(min.x / tile.x)), int(std::floor(min.y / tile.y)) };
+        olc::vi2d last = { int(std::ceil(max.x / tile.x)) - 1, int(std::ceil(max.y / tile.y)) - 1 };
+        for (int y = first.y; y <= last.y; y++)
+            for (int x = first.x; x <= last.x; x++)
+                if (IsObstacle(tiles, { x, y }))
+                    return true;
+
+        // only check collision on collidables within a tile from the player, those are all in the cells around it
+        const mColliderFilter monsters = { CategoryMask(CATEGORY_MONSTER) };
+        mPossibleCollidables = 0;
+        bool collided = false;
+        olc::vf2d around = olc::vf2d(float(player.nX), float(player.nY)) - olc::vf2d(TILE_SIZE, TILE_SIZE);
+        mColliderGrid.Query(around, { 3.0f * TILE_SIZE, 3.0f * TILE_SIZE }, [&](mCollider* c)
+        {
+            if (collided ||
+                std::abs(c->position.y - player.nY) > TILE_SIZE ||
+                std::abs(c->position.x - player.nX) > TILE_SIZE ||
+                (c->flags & COLLIDER_DESTROYED))
+                return;
+            if (monsters.Matches(c->flags) && CheckPositionalCollision(mPlayerCollider, *c))
+            {
+                collided = true;
+                return;
             }
             mPossibleCollidables += 1;
-        }
-        return false;
+        });
+        return collided;
     }
 
     void UpdateProjectile(mProjectile& p)
     {
-        if (CheckCollisions())
-            return;
-
         if (p.position.x < camera.vecCamPos.x ||
             p.position.x > camera.vecCamPos.x + camera.vecCamViewSize.x ||
             p.position.y > camera.vecCamPos.y + camera.vecCamViewSize.y ||
@@ -553,14 +1062,22 @@ public:
             mProjectiles.pop_back();
 
         mProjectileCollider.position = p.position;
+        olc::vf2d step = { 0.0f, 0.0f };
         if (p.direction == "idle-left" || p.direction == "walking-left")
-            p.position.x -= (SPEED * 2) * GetElapsedTime();
+            step.x -= (SPEED * 2) * GetElapsedTime();
         if (p.direction == "idle-right" || p.direction == "walking-right")
-            p.position.x += (SPEED * 2) * GetElapsedTime();
+            step.x += (SPEED * 2) * GetElapsedTime();
         if (p.direction == "idle-down" || p.direction == "walking-down")
-            p.position.y += (SPEED * 2) * GetElapsedTime();
+            step.y += (SPEED * 2) * GetElapsedTime();
         if (p.direction == "idle-up" || p.direction == "walking-up")
-            p.position.y -= (SPEED * 2) * GetElapsedTime();
+            step.y -= (SPEED * 2) * GetElapsedTime();
+
+        // Every tile on the way is tested, however long the frame took it can't skip over a wall
+        float travelled = SweepTiles(mProjectileCollider.position, mProjectileCollider.size, step, CategoryMask(CATEGORY_TERRAIN));
+        p.step = step * travelled;
+        p.position += p.step;
+        if (travelled < 1.0f && !mProjectiles.empty())
+            mProjectiles.pop_back();
 
         if (mProjectileRotation >= 360.0f)
             mProjectileRotation = 0.0f;
@@ -602,7 +1119,7 @@ public:
                 { player.x + 16.0f , player.y + 16.0f },
                 { static_cast<float>(mProjectileSprite.Sprite()->width), static_cast<float>(mProjectileSprite.Sprite()->height) }, false, mSpriteStateName });
 	    
-            mProjectileCollider = { "projectile", { player.x + 16.0f, player.y + 16.0f },
+            mProjectileCollider = { CategoryMask(CATEGORY_PROJECTILE), { player.x + 16.0f, player.y + 16.0f },
                 { static_cast<float>(mProjectileSprite.Sprite()->width - 2), static_cast<float>(mProjectileSprite.Sprite()->height) } };
 	    
             mProjectileRotation = 0.0f;
@@ -721,7 +1238,8 @@ public:
 	    float sqrtAns = sqrt(x + y);
 	    olc::vf2d normalized = direction / sqrtAns;
 
-	    monster->projectile.back()->position -= (normalized * (SPEED * 2)) * GetElapsedTime();
+	    monster->projectile.back()->step = normalized * (SPEED * 2) * -GetElapsedTime();
+	    monster->projectile.back()->position += monster->projectile.back()->step;
 
 	    monster->projectileCollider->position = monster->projectile.back()->position;
 	}
@@ -732,7 +1250,7 @@ public:
     {
 	monster->projectile.pop_back();
 	monster->savedPlayerPos = { 0, 0 };
-	monster->projectileCollider->tag = "_destroyed_";
+	monster->projectileCollider->flags |= COLLIDER_DESTROYED;
     }
 
     void CreateMonsterProjectile(mMonster* monster)
@@ -746,7 +1264,7 @@ public:
 		    { monster->position.x * TILE_SIZE, monster->position.y * TILE_SIZE },
 		    { static_cast<float>(mProjectileSprite.Sprite()->width), static_cast<float>(mProjectileSprite.Sprite()->height) },
 		      false, ""});
-	    monster->projectileCollider = new mCollider{ "projectile", monster->position,
+	    monster->projectileCollider = new mCollider{ CategoryMask(CATEGORY_MONSTER_PROJECTILE), monster->position,
 							 { static_cast<float>(mProjectileSprite.Sprite()->width - 2),
 							   static_cast<float>(mProjectileSprite.Sprite()->height) } };
 	}
@@ -758,7 +1276,7 @@ public:
         auto p = [&](int x, int y) { return y * mMapSizeX + x; };
         for (auto* monster : mMonsters)
         {
-            if (monster->collider->tag == "_destroyed_")
+            if (monster->collider->flags & COLLIDER_DESTROYED)
                 continue;
             FillRectDecal((monster->position * TILE_SIZE) - camera.vecCamPos, { TILE_SIZE, TILE_SIZE }, olc::BLUE);
             DrawStringDecal((monster->position * TILE_SIZE) - camera.vecCamPos, std::to_string(monster->health), olc::GREEN);
@@ -773,28 +1291,47 @@ public:
 		std::abs(monster->position.x - monster->projectile.back()->position.x / TILE_SIZE) > FOV / 2 &&
 		std::abs(monster->position.y - monster->projectile.back()->position.y / TILE_SIZE) > FOV / 2)
 		DeleteMonsterProjectile(monster);
-
-	    CheckMonsterCollision(monster);
         }
     }
 
     void DrawMap()
     {
+        // Load the chunks around the camera and let go of the ones far behind it
+        mMapStreamer.Update(camera.vecCamPos, camera.vecCamViewSize);
+
+        // Only the chunks under the viewport are visited, each one is a single decal
+        olc::vi2d chunkSize = mMap->vTileSize * mMapStreamer.nChunkSize;
+        olc::vi2d first = {
+            std::max(0, static_cast<int>(std::floor(camera.vecCamPos.x / chunkSize.x))),
+            std::max(0, static_cast<int>(std::floor(camera.vecCamPos.y / chunkSize.y))) };
+        olc::vi2d last = {
+            std::min((mMapSizeX + mMapStreamer.nChunkSize - 1) / mMapStreamer.nChunkSize,
+                static_cast<int>(std::floor((camera.vecCamPos.x + camera.vecCamViewSize.x) / chunkSize.x)) + 1),
+            std::min((mMapSizeY + mMapStreamer.nChunkSize - 1) / mMapStreamer.nChunkSize,
+                static_cast<int>(std::floor((camera.vecCamPos.y + camera.vecCamViewSize.y) / chunkSize.y)) + 1) };
+
         mTilesDrawnOnMap = 0;
-        for (auto* tile : mTiles)
-        {
-            // Set rendering bounds, if tile that is suppose to be rendered is not within the viewport
-            // Or if the tile is destroyed we shall not render it.
-            if (tile->position.y + TILE_SIZE < camera.vecCamPos.y ||
-                tile->position.y > camera.vecCamPos.y + camera.vecCamViewSize.y ||
-                tile->position.x + TILE_SIZE < camera.vecCamPos.x ||
-                tile->position.x > camera.vecCamPos.x + camera.vecCamViewSize.x)
-                continue;
-            if (tile->destroyed)
-                continue;
+        mTilesHiddenOnMap = 0;
+        mChunksDrawnOnMap = 0;
+        for (int y = first.y; y < last.y; y++)
+        {
+            for (int x = first.x; x < last.x; x++)
+            {
+                auto it = mMapChunks.find(olc::MapStreamer::Key(x, y));
+                if (it == mMapChunks.end())
+                    continue;
 
-            DrawPartialDecal(tile->position - camera.vecCamPos, mSpriteSheet.Decal(), tile->tilesheetPos, { 32, 32 });
-            mTilesDrawnOnMap += 1;
+                mMapChunk& chunk = it->second;
+                if (chunk.dirty)
+                    BakeChunk({ x, y }, chunk);
+                if (chunk.tiles == 0)
+                    continue;
+
+                DrawDecal(olc::vf2d(olc::vi2d(x, y) * chunkSize) - camera.vecCamPos, chunk.baked->Decal());
+                mTilesDrawnOnMap += chunk.tiles;
+                mTilesHiddenOnMap += chunk.hidden;
+                mChunksDrawnOnMap += 1;
+            }
         }
     }
 
@@ -802,11 +1339,11 @@ public:
     {
         for (auto* c : mColliders)
         {
-            if (c->tag == "_destroyed_")
+            if (c->flags & COLLIDER_DESTROYED)
             {
-                c->tag = "map_terrain";
-                if (c->tile)
-                    c->tile->destroyed = false;
+                c->flags &= ~COLLIDER_DESTROYED;
+                if (c->tile >= 0)
+                    SetTileDestroyed(c->tile, false);
             }
 
         }
@@ -835,6 +1372,7 @@ public:
             SpawnPlayer();
         DrawMap();
 	HandleMonsters();
+        HandleDynamicCollisions();
         PlayerInput();
         UpdatePlayer();
         if (!mProjectiles.empty())
@@ -848,14 +1386,18 @@ public:
         // Debug collidables
         if (mDebugMode)
         {
-            for (auto* c : mColliders)
+            mColliderGrid.Query(camera.vecCamPos, camera.vecCamViewSize, [&](mCollider* c)
             {
-                if (c->tag == "_destroyed_")
-                    continue;
-		FillRectDecal(c->position - camera.vecCamPos, c->size, olc::RED);
-            }
+                if (!(c->flags & COLLIDER_DESTROYED))
+                    FillRectDecal(c->position - camera.vecCamPos, c->size, olc::RED);
+            });
             DrawStringDecal({ 1.0f, 30.0f }, "Collidables: " + std::to_string(mPossibleCollidables), olc::WHITE, { 2.0f, 2.0f });
-            DrawStringDecal({ 1.0f, 50.0f }, "Tiles Drawn: " + std::to_string(mTilesDrawnOnMap), olc::WHITE, { 2.0f, 2.0f });
+            DrawStringDecal({ 1.0f, 50.0f }, "Tiles Drawn: " + std::to_string(mTilesDrawnOnMap) + " in " +
+                std::to_string(mChunksDrawnOnMap) + " decals, " + std::to_string(mTilesHiddenOnMap) + " hidden", olc::WHITE, { 2.0f, 2.0f });
+            DrawStringDecal({ 1.0f, 70.0f }, "Chunks: " + std::to_string(mMapStreamer.ResidentChunks()) + " (" +
+                std::to_string(mMapStreamer.ResidentBytes() / 1024) + " KB)", olc::WHITE, { 2.0f, 2.0f });
+            DrawStringDecal({ 1.0f, 90.0f }, "Dynamic Pairs: " + std::to_string(mDynamicBodies.PairsTested()) + " tested, " +
+                std::to_string(mDynamicBodies.Overlaps()) + " overlapping", olc::WHITE, { 2.0f, 2.0f });
         }
     }
 
@@ -870,11 +1412,19 @@ public:
             mSpawnPlayer = true;
         if (GetKey(olc::F3).bPressed)
             RespawnColliders();
+        if (mMapWatcher.Changed())
+            ReloadMap();
         switch (mGameState)
         {
         case GameState::SPLASHSCREEN:
             if (mSplashScreen.AnimateSplashScreen(fElapsedTime))
                 return true;
+            // Keep showing the progress until the loading thread is done
+            if (!mAssetsLoaded && !FinishLoading())
+            {
+                DrawLoadingScreen();
+                return true;
+            }
             mGameState++;
             break;
         case GameState::MENU:
@@ -907,6 +1457,7 @@ public:
 };
 
 
+#if !defined(OLC_PGE_HEADLESS)
 int main()
 {
     JinrisGame game;
@@ -915,3 +1466,101 @@ int main()
 
     return 0;
 }
+#else
+// Plays the game without a window for benchmarking, see `make bench`
+//
+//     bench_game [-frames N] [-rasterize] [-threads N] [-dt S]
+//
+// Enter is tapped until the game starts, then the player walks right, down,
+// left and up for 120 frames each and shoots every 45 frames, for N frames.
+// Every frame is 1/60s of game time, or S seconds for long frames, so runs
+// only differ in how long they take.
+int main(int argc, char* argv[])
+{
+    uint32_t nFrames = 1800;
+    for (int i = 1; i < argc; i++)
+    {
+        std::string arg = argv[i];
+        if (arg == "-frames" && i + 1 < argc) nFrames = std::max(1, atoi(argv[++i]));
+        else if (arg == "-rasterize") olc::headless.bRasterize = true;
+        else if (arg == "-threads" && i + 1 < argc) olc::headless.nRasterThreads = std::max(1, atoi(argv[++i]));
+        else if (arg == "-dt" && i + 1 < argc) olc::headless.fElapsedTime = std::max(0.001f, float(atof(argv[++i])));
+        else
+        {
+            std::cout << "Usage: bench_game [-frames N] [-rasterize] [-threads N] [-dt S]" << std::endl;
+            return 1;
+        }
+    }
+
+    JinrisGame game;
+    uint32_t nStart = 0;
+    bool bPlaying = false;
+    olc::headless.nFrames = 0;
+    olc::headless.funcInput = [&](olc::PixelGameEngine* pge, uint32_t nFrame)
+    {
+        if (!game.IsPlaying())
+        {
+            pge->olc_UpdateKeyState(olc::ENTER, nFrame % 2 == 0);
+            return;
+        }
+        if (!bPlaying)
+        {
+            bPlaying = true;
+            nStart = nFrame;
+            pge->olc_UpdateKeyState(olc::ENTER, false);
+        }
+
+        uint32_t t = nFrame - nStart;
+        const olc::Key walk[] = { olc::RIGHT, olc::DOWN, olc::LEFT, olc::UP };
+        for (int i = 0; i < 4; i++)
+            pge->olc_UpdateKeyState(walk[i], i == int(t / 120 % 4));
+        pge->olc_UpdateKeyState(olc::SPACE, t % 45 == 0);
+
+        // This frame still runs, the engine stops before the next
+        if (t + 1 >= nFrames)
+            pge->olc_Terminate();
+    };
+
+    if (!game.Construct(WINDOW_WIDTH, WINDOW_HEIGHT, 1, 1) || !game.Start() || !bPlaying)
+    {
+        std::cout << "The game never started" << std::endl;
+        return 1;
+    }
+
+    // Only the frames of the scripted run, not the splash screen or menu
+    std::vector<olc::HeadlessFrame> vFrames(olc::headless.vFrames.begin() + std::min<size_t>(nStart, olc::headless.vFrames.size()),
+        olc::headless.vFrames.end());
+    if (vFrames.empty())
+        return 1;
+
+    std::vector<float> vTimes;
+    double dTotal = 0.0, dDecals = 0.0, dCalls = 0.0, dBytes = 0.0;
+    for (auto& f : vFrames)
+    {
+        vTimes.push_back(f.fTime * 1000.0f);
+        dTotal += f.fTime * 1000.0;
+        dDecals += f.nDecalQuads;
+        dCalls += f.nDrawCalls;
+        dBytes += f.nUploadedBytes;
+    }
+    std::sort(vTimes.begin(), vTimes.end());
+    auto percentile = [&](double p) { return vTimes[std::min(vTimes.size() - 1, size_t(p * vTimes.size()))]; };
+
+    size_t n = vFrames.size();
+    printf("%zu frames after %u to get into the game%s\n", n, nStart, olc::headless.bRasterize ? ", rasterized" : "");
+    printf("    frame time    mean %.3f ms  p50 %.3f  p95 %.3f  p99 %.3f  max %.3f\n",
+        dTotal / n, percentile(0.50), percentile(0.95), percentile(0.99), vTimes.back());
+    printf("    per frame     %.1f decals in %.1f draw calls, %.1f KB uploaded\n", dDecals / n, dCalls / n, dBytes / 1024.0 / n);
+
+    if (olc::headless.pFrame)
+    {
+        // Same script and seed, so the last frame should be the same every run
+        uint64_t nHash = 14695981039346656037ull;
+        const olc::Pixel* p = olc::headless.pFrame->GetData();
+        for (int i = 0; i < olc::headless.pFrame->width * olc::headless.pFrame->height; i++)
+            nHash = (nHash ^ p[i].n) * 1099511628211ull;
+        printf("    last frame    %016llx\n", (unsigned long long)nHash);
+    }
+    return 0;
+}
+#endif
@@ -0,0 +1,40 @@
+// Offline map compiler, turns a Pyxel Edit JSON export or .pyxel document
+// into a .jmap that the game can memory map at startup
+//
+//     mapc ./sprites/jmap.json ./sprites/jmap.jmap [./sprites/tilesheet.png]
+//     mapc ./sprites/map.pyxel ./sprites/map.jmap [./sprites/tilesheet.png]
+#define OLC_PGE_APPLICATION
+#include "olcPixelGameEngine.h"
+#include "olcPGEX_PyxelMap.h"
+
+int main(int argc, char* argv[])
+{
+    if (argc < 3)
+    {
+        std::cout << "Usage: mapc <map.json|map.pyxel> <map.jmap> [tilesheet.png]" << std::endl;
+        return 1;
+    }
+
+    std::string tileSheet = argc > 3 ? argv[3] : "./sprites/tilesheet.png";
+
+    olc::PyxelMap map;
+    if (!map.Load(argv[1], tileSheet))
+    {
+        std::cout << "Failed to read " << argv[1] << std::endl;
+        return 1;
+    }
+
+    // A .jmap only references its tilesheet, so archive maps need the exported png
+    if (map.sTileSheet.empty())
+        map.sTileSheet = tileSheet;
+
+    if (!map.SaveToBinary(argv[2]))
+    {
+        std::cout << "Failed to write " << argv[2] << std::endl;
+        return 1;
+    }
+
+    std::cout << "Compiled " << argv[1] << " (" << map.vMapSize.x << "x" << map.vMapSize.y << ", "
+        << map.vLayers.size() << " layers) to " << argv[2] << std::endl;
+    return 0;
+}
@@ -0,0 +1,160 @@
+/*
+	olcPGEX_Atlas.h
+
+	+-------------------------------------------------------------+
+	|         OneLoneCoder Pixel Game Engine Extension            |
+	|                Atlas - v1.0                                 |
+	+-------------------------------------------------------------+
+
+	What is this?
+	~~~~~~~~~~~~~
+	This is an extension to the olcPixelGameEngine v2.0 and above.
+	It packs the sprites of several olc::Renderables into one or a
+	few large textures once they're loaded. Every renderable then
+	draws through its region of a page, so drawing them one after
+	the other doesn't switch textures and the renderer can draw
+	them in one go. Nothing changes for the code that draws them:
+
+			olc::Atlas atlas;
+			atlas.Add(&player);
+			atlas.Add(&projectile);
+			atlas.Build();
+
+			DrawDecal(pos, player.Decal());		// Same as before
+
+	Sprites are packed tallest first onto shelves, with their edge
+	pixels repeated into the padding around them so neighbours
+	can't bleed into each other. A sprite that doesn't fit on a
+	page keeps its own texture.
+
+	The renderables keep their sprites, but their decals now share
+	the atlas' textures: the atlas has to outlive them, and a change
+	to a sprite only shows up after building again.
+
+	Author
+	~~~~~~
+	Frowsty
+
+*/
+
+#ifndef OLC_PGEX_ATLAS
+#define OLC_PGEX_ATLAS
+
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+namespace olc
+{
+	class Atlas
+	{
+	public:
+		// Pack this renderable on the next Build, its sprite has to be loaded by then
+		inline void Add(olc::Renderable* pRenderable);
+		// Packs everything added since the last Build into new pages, returns how many were made
+		inline int Build(int nPageSize = 2048, int nPadding = 1);
+		inline void Clear();
+
+		size_t PageCount() const { return vPages.size(); }
+		olc::Renderable* GetPage(size_t nPage) const { return nPage < vPages.size() ? vPages[nPage].get() : nullptr; }
+
+	private:
+		std::vector<olc::Renderable*> vPending;
+		std::vector<std::unique_ptr<olc::Renderable>> vPages;
+	};
+}
+
+void olc::Atlas::Add(olc::Renderable* pRenderable)
+{
+	if (pRenderable != nullptr)
+		vPending.push_back(pRenderable);
+}
+
+int olc::Atlas::Build(int nPageSize, int nPadding)
+{
+	struct Placement
+	{
+		olc::Renderable* pRenderable;
+		size_t nPage;
+		olc::vi2d vPos;
+	};
+
+	std::vector<olc::Renderable*> vItems;
+	for (auto* r : vPending)
+	{
+		olc::Sprite* spr = r->Sprite();
+		if (spr != nullptr && spr->width + nPadding * 2 <= nPageSize && spr->height + nPadding * 2 <= nPageSize)
+			vItems.push_back(r);
+	}
+	vPending.clear();
+	if (vItems.empty())
+		return 0;
+
+	std::stable_sort(vItems.begin(), vItems.end(),
+		[](olc::Renderable* a, olc::Renderable* b) { return a->Sprite()->height > b->Sprite()->height; });
+
+	// Fill shelves left to right, start a new shelf when the row is full and a new page when the shelves are
+	std::vector<Placement> vPlacements;
+	std::vector<olc::vi2d> vPageSizes;
+	olc::vi2d vCursor = { 0, 0 };
+	int nShelfHeight = 0;
+	for (auto* r : vItems)
+	{
+		olc::vi2d vSize = { r->Sprite()->width + nPadding * 2, r->Sprite()->height + nPadding * 2 };
+		if (!vPageSizes.empty() && vCursor.x + vSize.x > nPageSize)
+		{
+			vCursor = { 0, vCursor.y + nShelfHeight };
+			nShelfHeight = 0;
+		}
+		if (vPageSizes.empty() || vCursor.y + vSize.y > nPageSize)
+		{
+			vPageSizes.push_back({ 0, 0 });
+			vCursor = { 0, 0 };
+			nShelfHeight = 0;
+		}
+
+		vPlacements.push_back({ r, vPageSizes.size() - 1, vCursor + olc::vi2d(nPadding, nPadding) });
+		vCursor.x += vSize.x;
+		nShelfHeight = std::max(nShelfHeight, vSize.y);
+		vPageSizes.back() = { std::max(vPageSizes.back().x, vCursor.x), std::max(vPageSizes.back().y, vCursor.y + nShelfHeight) };
+	}
+
+	size_t nFirstPage = vPages.size();
+	for (auto& vSize : vPageSizes)
+	{
+		auto page = std::make_unique<olc::Renderable>();
+		page->Create(vSize.x, vSize.y);
+		std::fill(page->Sprite()->GetData(), page->Sprite()->GetData() + vSize.x * vSize.y, olc::BLANK);
+		vPages.push_back(std::move(page));
+	}
+
+	// Copy every sprite in, the padding takes the nearest edge pixel
+	for (auto& p : vPlacements)
+	{
+		olc::Sprite* src = p.pRenderable->Sprite();
+		olc::Sprite* dst = vPages[nFirstPage + p.nPage]->Sprite();
+		for (int y = -nPadding; y < src->height + nPadding; y++)
+		{
+			const olc::Pixel* row = src->GetData() + std::clamp(y, 0, src->height - 1) * src->width;
+			olc::Pixel* out = dst->GetData() + (p.vPos.y + y) * dst->width + p.vPos.x;
+			for (int x = -nPadding; x < src->width + nPadding; x++)
+				out[x] = row[std::clamp(x, 0, src->width - 1)];
+		}
+	}
+
+	for (size_t i = nFirstPage; i < vPages.size(); i++)
+		vPages[i]->Decal()->Update();
+
+	for (auto& p : vPlacements)
+		p.pRenderable->SetDecal(std::make_unique<olc::Decal>(vPages[nFirstPage + p.nPage]->Decal(), p.pRenderable->Sprite(), p.vPos));
+
+	return int(vPageSizes.size());
+}
+
+void olc::Atlas::Clear()
+{
+	vPending.clear();
+	vPages.clear();
+}
+
+#endif
@@ -0,0 +1,156 @@
+/*
+	olcPGEX_FileWatcher.h
+
+	+-------------------------------------------------------------+
+	|         OneLoneCoder Pixel Game Engine Extension            |
+	|                FileWatcher - v1.0                           |
+	+-------------------------------------------------------------+
+
+	What is this?
+	~~~~~~~~~~~~~
+	This is an extension to the olcPixelGameEngine v2.0 and above.
+	It tells you when a file has been written, without blocking, so
+	it can be checked every frame:
+
+			olc::FileWatcher watcher;
+			watcher.Watch("./sprites/testing.jmap");
+
+			// Every frame
+			if (watcher.Changed())
+				ReloadMap();
+
+	On Linux the file's directory is watched with inotify, both saving
+	in place and saving to a temp file then renaming it over the
+	original are picked up. Elsewhere the file's modification time is
+	polled every fPollInterval seconds.
+
+	Author
+	~~~~~~
+	Frowsty
+
+*/
+
+#ifndef OLC_PGEX_FILEWATCHER
+#define OLC_PGEX_FILEWATCHER
+
+#include <chrono>
+#include <string>
+#include <system_error>
+
+#if defined(__linux__)
+	#include <sys/inotify.h>
+	#include <unistd.h>
+#endif
+
+namespace olc
+{
+	class FileWatcher
+	{
+	public:
+		FileWatcher() = default;
+		~FileWatcher() { Stop(); }
+		FileWatcher(const FileWatcher&) = delete;
+		FileWatcher& operator=(const FileWatcher&) = delete;
+
+		inline bool Watch(const std::string& sFile);
+		inline void Stop();
+		// True once for every time the file was written since the last call
+		inline bool Changed();
+
+	public:
+		// Only used when polling
+		float fPollInterval = 0.5f;
+
+	private:
+		inline bool Poll();
+
+	private:
+		std::string sFile;
+		_gfs::file_time_type tLastWrite;
+		std::chrono::steady_clock::time_point tLastPoll;
+	#if defined(__linux__)
+		int fdNotify = -1;
+		std::string sName;
+	#endif
+	};
+}
+
+bool olc::FileWatcher::Watch(const std::string& sPath)
+{
+	Stop();
+	sFile = sPath;
+
+	std::error_code ec;
+	tLastWrite = _gfs::last_write_time(sFile, ec);
+	tLastPoll = std::chrono::steady_clock::now();
+
+#if defined(__linux__)
+	// Watch the directory rather than the file, a file replaced by a rename is a new inode
+	_gfs::path path(sFile);
+	std::string sDir = path.has_parent_path() ? path.parent_path().string() : ".";
+	sName = path.filename().string();
+
+	fdNotify = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+	if (fdNotify >= 0 && inotify_add_watch(fdNotify, sDir.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO) < 0)
+	{
+		close(fdNotify);
+		fdNotify = -1;
+	}
+#endif
+	return !ec;
+}
+
+void olc::FileWatcher::Stop()
+{
+#if defined(__linux__)
+	if (fdNotify >= 0)
+		close(fdNotify);
+	fdNotify = -1;
+#endif
+	sFile.clear();
+}
+
+bool olc::FileWatcher::Changed()
+{
+	if (sFile.empty())
+		return false;
+
+#if defined(__linux__)
+	if (fdNotify >= 0)
+	{
+		// Drain every pending event, several writes in a row only count once
+		bool bChanged = false;
+		alignas(inotify_event) char buffer[4096];
+		ssize_t nRead;
+		while ((nRead = read(fdNotify, buffer, sizeof(buffer))) > 0)
+		{
+			for (char* p = buffer; p < buffer + nRead; )
+			{
+				const inotify_event* event = reinterpret_cast<const inotify_event*>(p);
+				if (event->len > 0 && sName == event->name)
+					bChanged = true;
+				p += sizeof(inotify_event) + event->len;
+			}
+		}
+		return bChanged;
+	}
+#endif
+	return Poll();
+}
+
+bool olc::FileWatcher::Poll()
+{
+	auto tNow = std::chrono::steady_clock::now();
+	if (std::chrono::duration<float>(tNow - tLastPoll).count() < fPollInterval)
+		return false;
+	tLastPoll = tNow;
+
+	std::error_code ec;
+	_gfs::file_time_type tWrite = _gfs::last_write_time(sFile, ec);
+	if (ec || tWrite == tLastWrite)
+		return false;
+	tLastWrite = tWrite;
+	return true;
+}
+
+#endif
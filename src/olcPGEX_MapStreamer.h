@@ -0,0 +1,403 @@
+/*
+	olcPGEX_MapStreamer.h
+
+	+-------------------------------------------------------------+
+	|         OneLoneCoder Pixel Game Engine Extension            |
+	|                MapStreamer - v1.0                           |
+	+-------------------------------------------------------------+
+
+	What is this?
+	~~~~~~~~~~~~~
+	This is an extension to the olcPixelGameEngine v2.0 and above.
+	It splits an olc::PyxelMap into fixed size chunks and keeps only
+	the chunks around the camera resident, so the cost of a map no
+	longer grows with the size of the world.
+
+	Chunks within nResidencyRadius chunks of the view are built on a
+	background thread before the camera reaches them. Chunks that end
+	up more than one chunk past that radius are evicted, as are the
+	least recently wanted chunks whenever the resident set goes over
+	nMemoryBudget. Chunks overlapping the view itself are never
+	evicted, and if one isn't ready when it's needed it is built
+	right away on the calling thread. A chunk counts its tiles against
+	the budget, plus nTileOverhead per tile and nChunkOverhead for
+	whatever else the game keeps alongside it.
+
+	Hook the callbacks up to create and destroy whatever the game
+	keeps per tile, they're only ever called from Update:
+
+			olc::MapStreamer streamer;
+			streamer.funcChunkLoaded = [&](const olc::MapStreamer::Chunk& chunk) { ... };
+			streamer.funcChunkEvicted = [&](const olc::MapStreamer::Chunk& chunk) { ... };
+			streamer.Start(&map);
+
+			// Every frame
+			streamer.Update(camera.vecCamPos, camera.vecCamViewSize);
+
+	The map must stay loaded and unchanged while the streamer runs.
+	With a compiled .jmap the tile grids are memory mapped, so only
+	the pages of resident chunks are ever read from disk.
+
+	To switch to a new version of the same map, diff the two and hand
+	both to Patch. Resident chunks with changes are rebuilt from the
+	new map and reported through funcChunkPatched together with their
+	changes, the rest of the resident chunks aren't touched:
+
+			std::vector<olc::PyxelMap::TileChange> changes;
+			if (map.Diff(newMap, changes))
+				streamer.Patch(&newMap, changes);
+
+	Author
+	~~~~~~
+	Frowsty
+
+*/
+
+#ifndef OLC_PGEX_MAPSTREAMER
+#define OLC_PGEX_MAPSTREAMER
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+#include "olcPGEX_PyxelMap.h"
+
+namespace olc
+{
+	class MapStreamer
+	{
+	public:
+		struct Tile
+		{
+			olc::vi2d vCell;	// Position in the world, in tiles
+			uint16_t id;
+			uint16_t layer;		// Index into PyxelMap::vLayers
+		};
+
+		struct Chunk
+		{
+			olc::vi2d vChunk;	// Position in the world, in chunks
+			// Non-empty tiles in layer order, bottom layer first
+			std::vector<Tile> vTiles;
+			size_t nBytes = 0;
+			uint32_t nLastWanted = 0;
+			uint32_t nGeneration = 0;	// Which version of the map this was built from
+		};
+
+	public:
+		MapStreamer() = default;
+		~MapStreamer() { Stop(); }
+
+		// Start streaming pMap, nothing is loaded until the first Update
+		inline void Start(const olc::PyxelMap* pMap);
+		// Stop the worker and drop every resident chunk, without calling funcChunkEvicted
+		inline void Stop();
+		// Load and evict chunks for a view given in world pixels
+		inline void Update(const olc::vf2d& vViewPos, const olc::vf2d& vViewSize);
+		// Switch to a new version of the map, vChanges must come from PyxelMap::Diff
+		inline void Patch(const olc::PyxelMap* pNewMap, const std::vector<olc::PyxelMap::TileChange>& vChanges);
+
+		size_t ResidentChunks() const { return mapResident.size(); }
+		size_t ResidentBytes() const { return nResidentBytes; }
+		const std::unordered_map<int64_t, Chunk>& GetResident() const { return mapResident; }
+		// What GetResident keys a chunk by, the row in the high half and the column in the low half
+		static int64_t Key(int x, int y) { return int64_t(uint64_t(uint32_t(y)) << 32 | uint32_t(x)); }
+
+	public:
+		// Chunk edge in tiles, can only be changed before Start
+		int nChunkSize = 32;
+		// How many chunks past the edge of the view are kept loaded
+		int nResidencyRadius = 1;
+		// Upper bound for the resident chunks, the view itself is always kept
+		size_t nMemoryBudget = 64 * 1024 * 1024;
+		// What the game keeps per resident tile on top of the streamer, counted against the budget
+		size_t nTileOverhead = 0;
+		// What the game keeps per resident chunk regardless of its tiles, like an image of it
+		size_t nChunkOverhead = 0;
+
+		std::function<void(const Chunk&)> funcChunkLoaded;
+		std::function<void(const Chunk&)> funcChunkEvicted;
+		std::function<void(const Chunk&, const std::vector<olc::PyxelMap::TileChange>&)> funcChunkPatched;
+
+	private:
+		inline Chunk BuildChunk(const olc::vi2d& vChunk, const olc::PyxelMap* pFrom) const;
+		inline void Insert(Chunk&& chunk);
+		inline void Evict(int64_t key);
+		inline void WorkerThread();
+
+	private:
+		const olc::PyxelMap* pMap = nullptr;
+		olc::vi2d vChunkCount = { 0, 0 };
+		uint32_t nFrame = 0;
+
+		// Main thread only
+		std::unordered_map<int64_t, Chunk> mapResident;
+		std::unordered_set<int64_t> setPending;
+		size_t nResidentBytes = 0;
+
+		// Shared with the worker, pMap and nGeneration only change under muxMap
+		std::thread worker;
+		std::mutex muxMap;
+		uint32_t nGeneration = 0;
+		std::mutex mux;
+		std::condition_variable cvWork;
+		std::deque<olc::vi2d> qRequests;
+		std::vector<Chunk> vReady;
+		std::atomic<bool> bRunning{ false };
+	};
+}
+
+void olc::MapStreamer::Start(const olc::PyxelMap* map)
+{
+	Stop();
+	pMap = map;
+	if (pMap == nullptr || nChunkSize <= 0)
+		return;
+
+	vChunkCount = { (pMap->vMapSize.x + nChunkSize - 1) / nChunkSize, (pMap->vMapSize.y + nChunkSize - 1) / nChunkSize };
+	bRunning = true;
+	worker = std::thread(&MapStreamer::WorkerThread, this);
+}
+
+void olc::MapStreamer::Stop()
+{
+	if (worker.joinable())
+	{
+		{
+			std::lock_guard<std::mutex> lock(mux);
+			bRunning = false;
+		}
+		cvWork.notify_all();
+		worker.join();
+	}
+	bRunning = false;
+
+	qRequests.clear();
+	vReady.clear();
+	setPending.clear();
+	mapResident.clear();
+	nResidentBytes = 0;
+	vChunkCount = { 0, 0 };
+}
+
+void olc::MapStreamer::Update(const olc::vf2d& vViewPos, const olc::vf2d& vViewSize)
+{
+	if (pMap == nullptr || vChunkCount.x == 0 || vChunkCount.y == 0)
+		return;
+	nFrame++;
+
+	olc::vi2d vChunkPixels = pMap->vTileSize * nChunkSize;
+	auto clampX = [&](int x) { return std::max(0, std::min(x, vChunkCount.x - 1)); };
+	auto clampY = [&](int y) { return std::max(0, std::min(y, vChunkCount.y - 1)); };
+
+	// Chunks the view overlaps, then the ones we want resident and the ones we don't evict yet
+	int viewX0 = clampX(int(std::floor(vViewPos.x / vChunkPixels.x)));
+	int viewY0 = clampY(int(std::floor(vViewPos.y / vChunkPixels.y)));
+	int viewX1 = clampX(int(std::floor((vViewPos.x + vViewSize.x - 1) / vChunkPixels.x)));
+	int viewY1 = clampY(int(std::floor((vViewPos.y + vViewSize.y - 1) / vChunkPixels.y)));
+	int wantX0 = viewX0 - nResidencyRadius, wantY0 = viewY0 - nResidencyRadius;
+	int wantX1 = viewX1 + nResidencyRadius, wantY1 = viewY1 + nResidencyRadius;
+	auto inView = [&](const olc::vi2d& c) { return c.x >= viewX0 && c.x <= viewX1 && c.y >= viewY0 && c.y <= viewY1; };
+	auto inKeep = [&](const olc::vi2d& c) { return c.x >= wantX0 - 1 && c.x <= wantX1 + 1 && c.y >= wantY0 - 1 && c.y <= wantY1 + 1; };
+
+	// Pick up whatever the worker finished since last frame
+	std::vector<Chunk> vFinished;
+	{
+		std::lock_guard<std::mutex> lock(mux);
+		vFinished.swap(vReady);
+
+		// Requests the camera has moved away from are not worth building anymore
+		auto it = std::stable_partition(qRequests.begin(), qRequests.end(), [&](const olc::vi2d& c) { return inKeep(c); });
+		for (auto i = it; i != qRequests.end(); ++i)
+			setPending.erase(Key(i->x, i->y));
+		qRequests.erase(it, qRequests.end());
+	}
+	for (auto& chunk : vFinished)
+	{
+		int64_t key = Key(chunk.vChunk.x, chunk.vChunk.y);
+		setPending.erase(key);
+		// Chunks built from a map we've since been patched away from are rebuilt later
+		if (mapResident.count(key) == 0 && inKeep(chunk.vChunk) && chunk.nGeneration == nGeneration)
+			Insert(std::move(chunk));
+	}
+
+	// The view has to be there this frame, build anything still missing ourselves
+	for (int y = viewY0; y <= viewY1; y++)
+		for (int x = viewX0; x <= viewX1; x++)
+			if (mapResident.count(Key(x, y)) == 0)
+				Insert(BuildChunk({ x, y }, pMap));
+
+	// Queue the rest of the residency area, nearest to the view first
+	std::vector<olc::vi2d> vRequests;
+	for (int y = std::max(0, wantY0); y <= std::min(wantY1, vChunkCount.y - 1); y++)
+		for (int x = std::max(0, wantX0); x <= std::min(wantX1, vChunkCount.x - 1); x++)
+		{
+			int64_t key = Key(x, y);
+			auto it = mapResident.find(key);
+			if (it != mapResident.end())
+				it->second.nLastWanted = nFrame;
+			else if (setPending.insert(key).second)
+				vRequests.push_back({ x, y });
+		}
+	if (!vRequests.empty())
+	{
+		auto distance = [&](const olc::vi2d& c)
+		{
+			int dx = c.x < viewX0 ? viewX0 - c.x : std::max(0, c.x - viewX1);
+			int dy = c.y < viewY0 ? viewY0 - c.y : std::max(0, c.y - viewY1);
+			return std::max(dx, dy);
+		};
+		std::sort(vRequests.begin(), vRequests.end(), [&](const olc::vi2d& a, const olc::vi2d& b) { return distance(a) < distance(b); });
+		{
+			std::lock_guard<std::mutex> lock(mux);
+			qRequests.insert(qRequests.end(), vRequests.begin(), vRequests.end());
+		}
+		cvWork.notify_one();
+	}
+
+	// Evict what the camera has left behind, the extra chunk of slack stops
+	// chunks on the border from being loaded and evicted over and over
+	std::vector<int64_t> vEvict;
+	for (auto& resident : mapResident)
+		if (!inKeep(resident.second.vChunk))
+			vEvict.push_back(resident.first);
+	for (int64_t key : vEvict)
+		Evict(key);
+
+	// Then the least recently wanted chunks until we fit the budget
+	while (nResidentBytes > nMemoryBudget)
+	{
+		auto oldest = mapResident.end();
+		for (auto it = mapResident.begin(); it != mapResident.end(); ++it)
+		{
+			if (inView(it->second.vChunk))
+				continue;
+			if (oldest == mapResident.end() || it->second.nLastWanted < oldest->second.nLastWanted)
+				oldest = it;
+		}
+		if (oldest == mapResident.end())
+			break;
+		Evict(oldest->first);
+	}
+}
+
+void olc::MapStreamer::Patch(const olc::PyxelMap* pNewMap, const std::vector<olc::PyxelMap::TileChange>& vChanges)
+{
+	if (pMap == nullptr || pNewMap == nullptr)
+		return;
+
+	// Anything the worker builds from here on uses the new map, whatever it
+	// already finished is thrown away by Update since the generation moved on
+	{
+		std::lock_guard<std::mutex> lock(muxMap);
+		pMap = pNewMap;
+		nGeneration++;
+	}
+
+	// Group the changes by the resident chunk they land in
+	std::unordered_map<int64_t, std::vector<olc::PyxelMap::TileChange>> mapTouched;
+	for (auto& change : vChanges)
+	{
+		int x = int(change.cell % uint32_t(pMap->vMapSize.x)) / nChunkSize;
+		int y = int(change.cell / uint32_t(pMap->vMapSize.x)) / nChunkSize;
+		int64_t key = Key(x, y);
+		if (mapResident.count(key) > 0)
+			mapTouched[key].push_back(change);
+	}
+
+	for (auto& touched : mapTouched)
+	{
+		Chunk& chunk = mapResident[touched.first];
+		Chunk rebuilt = BuildChunk(chunk.vChunk, pMap);
+		nResidentBytes += rebuilt.nBytes;
+		nResidentBytes -= chunk.nBytes;
+		chunk.vTiles = std::move(rebuilt.vTiles);
+		chunk.nBytes = rebuilt.nBytes;
+		chunk.nGeneration = nGeneration;
+		if (funcChunkPatched)
+			funcChunkPatched(chunk, touched.second);
+	}
+}
+
+olc::MapStreamer::Chunk olc::MapStreamer::BuildChunk(const olc::vi2d& vChunk, const olc::PyxelMap* pFrom) const
+{
+	Chunk chunk;
+	chunk.vChunk = vChunk;
+	chunk.nGeneration = nGeneration;
+
+	int x0 = vChunk.x * nChunkSize, y0 = vChunk.y * nChunkSize;
+	int x1 = std::min(x0 + nChunkSize, pFrom->vMapSize.x);
+	int y1 = std::min(y0 + nChunkSize, pFrom->vMapSize.y);
+
+	for (size_t l = 0; l < pFrom->vLayers.size(); l++)
+	{
+		const uint16_t* tiles = pFrom->vLayers[l].tiles;
+		for (int y = y0; y < y1; y++)
+			for (int x = x0; x < x1; x++)
+			{
+				uint16_t id = tiles[y * pFrom->vMapSize.x + x];
+				if (id != olc::PyxelMap::EMPTY_TILE)
+					chunk.vTiles.push_back({ { x, y }, id, uint16_t(l) });
+			}
+	}
+
+	chunk.vTiles.shrink_to_fit();
+	chunk.nBytes = sizeof(Chunk) + nChunkOverhead + chunk.vTiles.size() * (sizeof(Tile) + nTileOverhead);
+	return chunk;
+}
+
+void olc::MapStreamer::Insert(Chunk&& chunk)
+{
+	int64_t key = Key(chunk.vChunk.x, chunk.vChunk.y);
+	chunk.nLastWanted = nFrame;
+	nResidentBytes += chunk.nBytes;
+	auto& resident = mapResident.emplace(key, std::move(chunk)).first->second;
+	if (funcChunkLoaded)
+		funcChunkLoaded(resident);
+}
+
+void olc::MapStreamer::Evict(int64_t key)
+{
+	auto it = mapResident.find(key);
+	if (it == mapResident.end())
+		return;
+	if (funcChunkEvicted)
+		funcChunkEvicted(it->second);
+	nResidentBytes -= it->second.nBytes;
+	mapResident.erase(it);
+}
+
+void olc::MapStreamer::WorkerThread()
+{
+	while (true)
+	{
+		olc::vi2d vChunk;
+		{
+			std::unique_lock<std::mutex> lock(mux);
+			cvWork.wait(lock, [&] { return !bRunning || !qRequests.empty(); });
+			if (!bRunning)
+				return;
+			vChunk = qRequests.front();
+			qRequests.pop_front();
+		}
+
+		Chunk chunk;
+		{
+			std::lock_guard<std::mutex> lock(muxMap);
+			chunk = BuildChunk(vChunk, pMap);
+		}
+
+		std::lock_guard<std::mutex> lock(mux);
+		vReady.push_back(std::move(chunk));
+	}
+}
+
+#endif
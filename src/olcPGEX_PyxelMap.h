@@ -0,0 +1,1393 @@
+/*
+	olcPGEX_PyxelMap.h
+
+	+-------------------------------------------------------------+
+	|         OneLoneCoder Pixel Game Engine Extension            |
+	|                PyxelMap - v1.0                              |
+	+-------------------------------------------------------------+
+
+	What is this?
+	~~~~~~~~~~~~~
+	This is an extension to the olcPixelGameEngine v2.0 and above.
+	It loads tile maps made with Pyxel Edit into a compact in-memory
+	form: a list of layers, each one a row-major grid of 16-bit tile
+	ids, plus the tile size, map size and the tilesheet to draw from.
+
+	Three file formats are understood:
+
+	1) The JSON tilemap export from Pyxel Edit. This is the authoring
+	   format, it's what you get out of the editor. It is read with a
+	   streaming (SAX) parser, tiles are written into the layer grids
+	   as they are parsed and no JSON document is ever built. Layers
+	   don't depend on each other, so LoadFromJsonParallel finds where
+	   each one starts and ends and parses them on a pool of threads.
+
+	2) A compiled binary map (.jmap). This holds exactly the data
+	   above and is memory mapped on load, the tile grids are used in
+	   place so the load time doesn't depend on how big the JSON was.
+
+	3) The Pyxel Edit document itself (.pyxel). This is a zip archive,
+	   it is read in memory: docData.json is inflated and parsed, and
+	   the tilesheet can be rebuilt from the tileN.png entries with
+	   BuildTileSheet, so no export step is needed at all.
+
+	Compile a map once, ship the .jmap:
+
+			olc::PyxelMap map;
+			map.LoadFromJson("./sprites/jmap.json", "./sprites/tilesheet.png");
+			map.SaveToBinary("./sprites/jmap.jmap");
+
+	...and in the game just call Load, which picks the loader from
+	the file extension (.jmap, .pyxel, anything else is JSON):
+
+			map.Load("./sprites/jmap.jmap");
+			for (auto& layer : map.vLayers)
+				uint16_t id = layer.tiles[y * map.vMapSize.x + x];
+
+	Parsing a big JSON export takes a while, LoadCached keeps the
+	parsed map as a .jmap in a cache directory, keyed by a hash of the
+	export's contents and the loader version. As long as the export
+	doesn't change, later loads just map the cached file:
+
+			map.LoadCached("./sprites/jmap.json", "./cache");
+
+	Tile ids are the same ids Pyxel writes to the export, a cell
+	without a tile holds olc::PyxelMap::EMPTY_TILE.
+
+	Author
+	~~~~~~
+	Frowsty
+
+*/
+
+#ifndef OLC_PGEX_PYXELMAP
+#define OLC_PGEX_PYXELMAP
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <charconv>
+#include <cstdio>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <map>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include "json.hpp"
+
+#if defined(_WIN32)
+	#if !defined(NOMINMAX)
+		#define NOMINMAX
+	#endif
+	#include <windows.h>
+#else
+	#include <fcntl.h>
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+	#include <unistd.h>
+#endif
+
+namespace olc
+{
+	// Read only view of a whole file mapped into memory
+	class MappedFile
+	{
+	public:
+		MappedFile() = default;
+		~MappedFile() { Close(); }
+		MappedFile(const MappedFile&) = delete;
+		MappedFile& operator=(const MappedFile&) = delete;
+
+		inline bool Open(const std::string& sFile);
+		inline void Close();
+		const uint8_t* Data() const { return pData; }
+		size_t Size() const { return nSize; }
+
+	private:
+		const uint8_t* pData = nullptr;
+		size_t nSize = 0;
+	#if defined(_WIN32)
+		HANDLE hFile = INVALID_HANDLE_VALUE;
+		HANDLE hMapping = nullptr;
+	#endif
+	};
+
+	// Reads entries out of a zip archive held in memory, only stored and
+	// deflated entries are supported, which is all Pyxel Edit writes
+	class ZipArchive
+	{
+	public:
+		inline bool Open(const uint8_t* pData, size_t nSize);
+		inline void Close();
+		bool Contains(const std::string& sName) const { return mapEntries.count(sName) > 0; }
+		// Decompress an entry into vOut, the CRC is checked
+		inline bool Extract(const std::string& sName, std::vector<uint8_t>& vOut) const;
+
+	private:
+		struct Entry
+		{
+			uint16_t method;
+			uint32_t crc;
+			uint32_t compressedSize;
+			uint32_t size;
+			uint32_t localOffset;
+		};
+
+		static uint16_t Read16(const uint8_t* p) { return uint16_t(p[0] | (p[1] << 8)); }
+		static uint32_t Read32(const uint8_t* p) { return uint32_t(p[0]) | (uint32_t(p[1]) << 8) | (uint32_t(p[2]) << 16) | (uint32_t(p[3]) << 24); }
+
+		const uint8_t* pData = nullptr;
+		size_t nSize = 0;
+		std::map<std::string, Entry> mapEntries;
+	};
+
+	// Decompress a raw DEFLATE stream, appending to vOut
+	inline bool Inflate(const uint8_t* pIn, size_t nIn, std::vector<uint8_t>& vOut);
+	inline uint32_t Crc32(const uint8_t* pData, size_t nSize);
+
+	class PyxelMap
+	{
+	public:
+		static constexpr uint16_t EMPTY_TILE = 0xFFFF;
+
+		struct Layer
+		{
+			std::string name;
+			// vMapSize.x * vMapSize.y tile ids, row-major
+			const uint16_t* tiles = nullptr;
+		};
+
+		// One cell that holds a different tile in two versions of a map
+		struct TileChange
+		{
+			uint16_t layer;
+			uint32_t cell;	// Row-major, same as the layer grids
+			uint16_t from;
+			uint16_t to;
+		};
+
+	public:
+		// Load a map, .jmap files are mapped in place, anything else is parsed as JSON
+		inline bool Load(const std::string& sFile, const std::string& sTileSheet = "./sprites/tilesheet.png");
+		// Same, but JSON maps are parsed once and then loaded from a .jmap in sCacheDir until they change
+		inline bool LoadCached(const std::string& sFile, const std::string& sCacheDir = "./cache",
+			const std::string& sTileSheet = "./sprites/tilesheet.png");
+		// Where LoadCached keeps the parsed version of a JSON map, empty if the map can't be read
+		static inline std::string CachePath(const std::string& sFile, const std::string& sCacheDir, const std::string& sTileSheet);
+		// Stream the Pyxel Edit JSON export straight into the layer grids
+		inline bool LoadFromJson(const std::string& sFile, const std::string& sTileSheet);
+		// Same, with the layers parsed concurrently, 0 threads uses one per core
+		inline bool LoadFromJsonParallel(const std::string& sFile, const std::string& sTileSheet, int nThreads = 0);
+		// Parse the Pyxel Edit JSON export into a full document first, kept for comparison
+		inline bool LoadFromJsonDom(const std::string& sFile, const std::string& sTileSheet);
+		// Map a compiled map into memory, tile grids are not copied
+		inline bool LoadFromBinary(const std::string& sFile);
+		// Read a Pyxel Edit document straight out of its archive
+		inline bool LoadFromPyxel(const std::string& sFile);
+		// True when the map came from a .pyxel archive that holds its own tiles
+		bool HasArchiveTileSheet() const { return vTileSheetSize.x > 0; }
+		// Draw the archive's tileN.png entries into spr, which must be vTileSheetSize
+		inline bool BuildTileSheet(olc::Sprite* spr) const;
+		// Write the compiled map, an existing file is only replaced once the new one is complete
+		inline bool SaveToBinary(const std::string& sFile) const;
+		inline void Clear();
+		// Tile id at grid position x, y of a layer
+		uint16_t GetTile(size_t layer, int x, int y) const { return vLayers[layer].tiles[y * vMapSize.x + x]; }
+		// List the cells that differ in other, false if the maps differ in size or layers
+		inline bool Diff(const PyxelMap& other, std::vector<TileChange>& vChanges) const;
+
+	public:
+		olc::vi2d vMapSize = { 0, 0 };
+		olc::vi2d vTileSize = { 0, 0 };
+		std::string sTileSheet;
+		std::vector<Layer> vLayers;
+		// Only set for maps loaded from a .pyxel archive
+		olc::vi2d vTileSheetSize = { 0, 0 };
+		int nTileSheetColumns = 0;
+		int nTileCount = 0;
+
+	private:
+		// On disk layout of a compiled map, every offset is from the start of the file
+		static constexpr uint32_t BINARY_MAGIC = 0x50414D4A; // "JMAP"
+		static constexpr uint32_t BINARY_VERSION = 1;
+		// Part of every cache key, bump it whenever a change to the JSON loaders changes their output
+		static constexpr uint32_t LOADER_VERSION = 1;
+
+		struct BinaryHeader
+		{
+			uint32_t magic;
+			uint32_t version;
+			uint32_t tilesWide;
+			uint32_t tilesHigh;
+			uint32_t tileWidth;
+			uint32_t tileHeight;
+			uint32_t layerCount;
+			uint32_t tileSheetOffset;
+			uint32_t tileSheetLength;
+		};
+
+		struct BinaryLayer
+		{
+			uint32_t nameOffset;
+			uint32_t nameLength;
+			uint32_t tilesOffset;
+			uint32_t reserved;
+		};
+
+		class JsonSaxHandler;
+		inline bool WriteBinary(const std::string& sFile) const;
+		// Members of a parsed document, nothing (or false) when they're missing or of another type. Reading
+		// them through these instead of at() and get() keeps a malformed map from throwing
+		static inline const nlohmann::json* JsonMember(const nlohmann::json& j, const char* sKey, nlohmann::json::value_t type);
+		static inline bool JsonInt(const nlohmann::json& j, const char* sKey, int& n);
+		// A key holding a layer number or a cell index, false for anything else
+		static inline bool JsonIndex(const std::string& sKey, size_t& n);
+		static inline bool FindJsonLayers(const char* pData, size_t nSize, size_t& nArrayBegin, size_t& nArrayEnd,
+			std::vector<std::pair<size_t, size_t>>& vLayerRanges);
+
+		// Grids we own when the map was parsed rather than mapped
+		std::vector<std::vector<uint16_t>> vLayerStorage;
+		MappedFile mappedFile;
+		ZipArchive archive;
+	};
+}
+
+// Walks the SAX events of a Pyxel JSON export, only the handful of values
+// the map needs are kept, everything else is skipped as it streams past
+class olc::PyxelMap::JsonSaxHandler : public nlohmann::json_sax<nlohmann::json>
+{
+public:
+	JsonSaxHandler(olc::PyxelMap& m) : map(m) {}
+
+	// Parses a single layer object on its own, the map dimensions come from the root
+	JsonSaxHandler(olc::PyxelMap& m, const olc::vi2d& vMapSize, const olc::vi2d& vTileSize)
+		: map(m), tilesWide(vMapSize.x), tilesHigh(vMapSize.y), tileWidth(vTileSize.x), tileHeight(vTileSize.y)
+	{
+		vScope.push_back(Scope::LAYERS);
+	}
+
+	bool null() override { return true; }
+	bool boolean(bool) override { return true; }
+	bool number_integer(number_integer_t val) override { return Number(int64_t(val)); }
+	bool number_unsigned(number_unsigned_t val) override { return Number(int64_t(val)); }
+	bool number_float(number_float_t, const string_t&) override { return true; }
+	bool binary(binary_t&) override { return true; }
+
+	bool string(string_t& val) override
+	{
+		if (Top() == Scope::LAYER && sKey == "name")
+			pending.back().name = val;
+		return true;
+	}
+
+	bool key(string_t& val) override
+	{
+		sKey = val;
+		return true;
+	}
+
+	bool start_object(std::size_t) override
+	{
+		if (vScope.empty())
+			vScope.push_back(Scope::ROOT);
+		else if (Top() == Scope::LAYERS)
+		{
+			pending.emplace_back();
+			vScope.push_back(Scope::LAYER);
+		}
+		else if (Top() == Scope::TILES)
+		{
+			tile = PendingTile();
+			vScope.push_back(Scope::TILE);
+		}
+		else
+			vScope.push_back(Scope::OTHER);
+		return true;
+	}
+
+	bool end_object() override
+	{
+		Scope scope = Top();
+		vScope.pop_back();
+		if (scope == Scope::TILE)
+			StoreTile();
+		return true;
+	}
+
+	bool start_array(std::size_t) override
+	{
+		if (Top() == Scope::ROOT && sKey == "layers")
+			vScope.push_back(Scope::LAYERS);
+		else if (Top() == Scope::LAYER && sKey == "tiles")
+			vScope.push_back(Scope::TILES);
+		else
+			vScope.push_back(Scope::OTHER);
+		return true;
+	}
+
+	bool end_array() override
+	{
+		vScope.pop_back();
+		return true;
+	}
+
+	bool parse_error(std::size_t, const std::string&, const nlohmann::detail::exception&) override
+	{ return false; }
+
+	// Called once the whole document has streamed past
+	bool Finish()
+	{
+		if (!PlaceTiles())
+			return false;
+		Commit();
+		return true;
+	}
+
+	// Sizes every grid and places any tiles that arrived before the map width was
+	// known, this only touches the handler so layer handlers can run it on any thread
+	bool PlaceTiles()
+	{
+		if (tilesWide <= 0 || tilesHigh <= 0 || tileWidth <= 0 || tileHeight <= 0)
+			return false;
+
+		const size_t nTiles = size_t(tilesWide) * size_t(tilesHigh);
+		for (auto& layer : pending)
+		{
+			layer.grid.resize(nTiles, EMPTY_TILE);
+			for (auto& t : layer.unplaced)
+				if (t.x >= 0 && t.y >= 0 && t.x < tilesWide && t.y < tilesHigh)
+					layer.grid[size_t(t.y) * tilesWide + t.x] = uint16_t(t.tile);
+			layer.unplaced.clear();
+		}
+		return true;
+	}
+
+	// Hands the layers over to the map, in the order they were parsed
+	void Commit()
+	{
+		map.vMapSize = { tilesWide, tilesHigh };
+		map.vTileSize = { tileWidth, tileHeight };
+		for (auto& layer : pending)
+		{
+			map.vLayerStorage.push_back(std::move(layer.grid));
+			map.vLayers.push_back({ layer.name, map.vLayerStorage.back().data() });
+		}
+		pending.clear();
+	}
+
+	olc::vi2d MapSize() const { return { tilesWide, tilesHigh }; }
+	olc::vi2d TileSize() const { return { tileWidth, tileHeight }; }
+
+private:
+	enum class Scope { ROOT, LAYERS, LAYER, TILES, TILE, OTHER };
+
+	struct PendingTile
+	{
+		int64_t x = -1;
+		int64_t y = -1;
+		int64_t index = -1;
+		int64_t tile = -1;
+	};
+
+	struct PendingLayer
+	{
+		std::string name;
+		std::vector<uint16_t> grid;
+		// Only used for tiles without an "index" that show up before "tileswide"
+		std::vector<PendingTile> unplaced;
+	};
+
+	Scope Top() const { return vScope.empty() ? Scope::OTHER : vScope.back(); }
+
+	bool Number(int64_t val)
+	{
+		switch (Top())
+		{
+		case Scope::ROOT:
+			if (sKey == "tileswide") tilesWide = int32_t(val);
+			else if (sKey == "tileshigh") tilesHigh = int32_t(val);
+			else if (sKey == "tilewidth") tileWidth = int32_t(val);
+			else if (sKey == "tileheight") tileHeight = int32_t(val);
+			break;
+		case Scope::TILE:
+			if (sKey == "x") tile.x = val;
+			else if (sKey == "y") tile.y = val;
+			else if (sKey == "index") tile.index = val;
+			else if (sKey == "tile") tile.tile = val;
+			break;
+		default:
+			break;
+		}
+		return true;
+	}
+
+	void StoreTile()
+	{
+		// Pyxel writes -1 for cells without a tile
+		if (tile.tile < 0 || tile.tile >= EMPTY_TILE)
+			return;
+
+		int64_t cell = tile.index;
+		if (cell < 0 && tilesWide > 0 && tile.x >= 0 && tile.y >= 0 && tile.x < tilesWide)
+			cell = tile.y * tilesWide + tile.x;
+		if (tilesWide > 0 && tilesHigh > 0 && cell >= int64_t(tilesWide) * tilesHigh)
+			return;
+
+		auto& layer = pending.back();
+		if (cell < 0)
+		{
+			layer.unplaced.push_back(tile);
+			return;
+		}
+
+		// The grid is row-major, so the Pyxel tile index is the grid index,
+		// it is grown here since the map height may not have been read yet
+		if (size_t(cell) >= layer.grid.size())
+			layer.grid.resize(std::max(size_t(cell) + 1, layer.grid.size() * 2), EMPTY_TILE);
+		layer.grid[size_t(cell)] = uint16_t(tile.tile);
+	}
+
+private:
+	olc::PyxelMap& map;
+	std::vector<Scope> vScope;
+	std::string sKey;
+	PendingTile tile;
+	std::vector<PendingLayer> pending;
+	int32_t tilesWide = 0;
+	int32_t tilesHigh = 0;
+	int32_t tileWidth = 0;
+	int32_t tileHeight = 0;
+};
+
+bool olc::MappedFile::Open(const std::string& sFile)
+{
+	Close();
+#if defined(_WIN32)
+	hFile = CreateFileA(sFile.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (hFile == INVALID_HANDLE_VALUE) return false;
+
+	LARGE_INTEGER size;
+	if (!GetFileSizeEx(hFile, &size) || size.QuadPart == 0) { Close(); return false; }
+	nSize = size_t(size.QuadPart);
+
+	hMapping = CreateFileMappingA(hFile, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	if (hMapping == nullptr) { Close(); return false; }
+
+	pData = (const uint8_t*)MapViewOfFile(hMapping, FILE_MAP_READ, 0, 0, 0);
+	if (pData == nullptr) { Close(); return false; }
+#else
+	int fd = open(sFile.c_str(), O_RDONLY);
+	if (fd < 0) return false;
+
+	struct stat st;
+	if (fstat(fd, &st) != 0 || st.st_size == 0) { close(fd); return false; }
+	nSize = size_t(st.st_size);
+
+	void* p = mmap(nullptr, nSize, PROT_READ, MAP_PRIVATE, fd, 0);
+	// The mapping keeps its own reference to the file
+	close(fd);
+	if (p == MAP_FAILED) { nSize = 0; return false; }
+	pData = (const uint8_t*)p;
+#endif
+	return true;
+}
+
+void olc::MappedFile::Close()
+{
+#if defined(_WIN32)
+	if (pData) UnmapViewOfFile(pData);
+	if (hMapping) CloseHandle(hMapping);
+	if (hFile != INVALID_HANDLE_VALUE) CloseHandle(hFile);
+	hMapping = nullptr;
+	hFile = INVALID_HANDLE_VALUE;
+#else
+	if (pData) munmap((void*)pData, nSize);
+#endif
+	pData = nullptr;
+	nSize = 0;
+}
+
+// A small DEFLATE decoder (RFC 1951), written after Mark Adler's puff.
+// It decodes a bit at a time, which is plenty for the few hundred KB a
+// Pyxel document holds and keeps us from needing zlib on every platform
+class olc_Inflater
+{
+public:
+	olc_Inflater(const uint8_t* pIn, size_t nIn, std::vector<uint8_t>& vOut) : in(pIn), inLen(nIn), out(vOut) {}
+
+	bool Run()
+	{
+		uint32_t last;
+		do
+		{
+			last = Bits(1);
+			uint32_t type = Bits(2);
+			bool ok = false;
+			if (type == 0) ok = Stored();
+			else if (type == 1) ok = Fixed();
+			else if (type == 2) ok = Dynamic();
+			if (!ok || bError) return false;
+		} while (!last);
+		return true;
+	}
+
+private:
+	static constexpr int MAX_BITS = 15;
+
+	struct Huffman
+	{
+		int16_t count[MAX_BITS + 1];
+		int16_t symbol[288];
+	};
+
+	uint32_t Bits(int need)
+	{
+		uint32_t val = bitBuf;
+		while (bitCnt < need)
+		{
+			if (inPos >= inLen) { bError = true; return 0; }
+			val |= uint32_t(in[inPos++]) << bitCnt;
+			bitCnt += 8;
+		}
+		bitBuf = val >> need;
+		bitCnt -= need;
+		return val & ((1u << need) - 1);
+	}
+
+	bool Stored()
+	{
+		// Stored blocks start on a byte boundary
+		bitBuf = 0;
+		bitCnt = 0;
+		if (inPos + 4 > inLen) return false;
+		uint32_t len = in[inPos] | (in[inPos + 1] << 8);
+		uint32_t nlen = in[inPos + 2] | (in[inPos + 3] << 8);
+		inPos += 4;
+		if (len != (~nlen & 0xFFFF) || inPos + len > inLen) return false;
+		out.insert(out.end(), in + inPos, in + inPos + len);
+		inPos += len;
+		return true;
+	}
+
+	// Returns 0 for a complete code, > 0 for an incomplete one and < 0 if over-subscribed
+	static int Construct(Huffman& h, const int16_t* length, int n)
+	{
+		for (int len = 0; len <= MAX_BITS; len++) h.count[len] = 0;
+		for (int sym = 0; sym < n; sym++) h.count[length[sym]]++;
+		if (h.count[0] == n) return 0;
+
+		int left = 1;
+		for (int len = 1; len <= MAX_BITS; len++)
+		{
+			left <<= 1;
+			left -= h.count[len];
+			if (left < 0) return left;
+		}
+
+		int16_t offs[MAX_BITS + 1];
+		offs[1] = 0;
+		for (int len = 1; len < MAX_BITS; len++) offs[len + 1] = offs[len] + h.count[len];
+		for (int sym = 0; sym < n; sym++)
+			if (length[sym] != 0) h.symbol[offs[length[sym]]++] = int16_t(sym);
+		return left;
+	}
+
+	int Decode(const Huffman& h)
+	{
+		int code = 0, first = 0, index = 0;
+		for (int len = 1; len <= MAX_BITS; len++)
+		{
+			code |= int(Bits(1));
+			if (bError) return -1;
+			int count = h.count[len];
+			if (code - count < first) return h.symbol[index + (code - first)];
+			index += count;
+			first += count;
+			first <<= 1;
+			code <<= 1;
+		}
+		return -1;
+	}
+
+	bool Codes(const Huffman& lencode, const Huffman& distcode)
+	{
+		static const int16_t lbase[29] = { 3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31, 35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258 };
+		static const int16_t lext[29] = { 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0 };
+		static const int16_t dbase[30] = { 1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193, 257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577 };
+		static const int16_t dext[30] = { 0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6, 7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13 };
+
+		int symbol;
+		do
+		{
+			symbol = Decode(lencode);
+			if (symbol < 0) return false;
+			if (symbol < 256)
+				out.push_back(uint8_t(symbol));
+			else if (symbol > 256)
+			{
+				symbol -= 257;
+				if (symbol >= 29) return false;
+				size_t len = lbase[symbol] + Bits(lext[symbol]);
+
+				int dsym = Decode(distcode);
+				if (dsym < 0 || dsym >= 30) return false;
+				size_t dist = dbase[dsym] + Bits(dext[dsym]);
+				if (bError || dist > out.size()) return false;
+
+				// Copy byte by byte, the match may overlap what it produces
+				size_t from = out.size() - dist;
+				for (size_t i = 0; i < len; i++)
+				{
+					uint8_t c = out[from + i];
+					out.push_back(c);
+				}
+			}
+		} while (symbol != 256);
+		return true;
+	}
+
+	bool Fixed()
+	{
+		int16_t lengths[288];
+		int sym = 0;
+		for (; sym < 144; sym++) lengths[sym] = 8;
+		for (; sym < 256; sym++) lengths[sym] = 9;
+		for (; sym < 280; sym++) lengths[sym] = 7;
+		for (; sym < 288; sym++) lengths[sym] = 8;
+		Huffman lencode, distcode;
+		Construct(lencode, lengths, 288);
+		for (sym = 0; sym < 30; sym++) lengths[sym] = 5;
+		Construct(distcode, lengths, 30);
+		return Codes(lencode, distcode);
+	}
+
+	bool Dynamic()
+	{
+		static const int16_t order[19] = { 16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15 };
+
+		int nlen = int(Bits(5)) + 257;
+		int ndist = int(Bits(5)) + 1;
+		int ncode = int(Bits(4)) + 4;
+		if (bError || nlen > 286 || ndist > 30) return false;
+
+		int16_t lengths[320];
+		int index = 0;
+		for (; index < ncode; index++) lengths[order[index]] = int16_t(Bits(3));
+		for (; index < 19; index++) lengths[order[index]] = 0;
+
+		Huffman lencode, distcode;
+		if (Construct(lencode, lengths, 19) != 0) return false;
+
+		// Read the literal/length and distance code lengths
+		index = 0;
+		while (index < nlen + ndist)
+		{
+			int symbol = Decode(lencode);
+			if (symbol < 0) return false;
+			if (symbol < 16)
+				lengths[index++] = int16_t(symbol);
+			else
+			{
+				int16_t len = 0;
+				int rep;
+				if (symbol == 16)
+				{
+					if (index == 0) return false;
+					len = lengths[index - 1];
+					rep = 3 + int(Bits(2));
+				}
+				else if (symbol == 17)
+					rep = 3 + int(Bits(3));
+				else
+					rep = 11 + int(Bits(7));
+				if (bError || index + rep > nlen + ndist) return false;
+				while (rep--) lengths[index++] = len;
+			}
+		}
+
+		// A block without an end code can't be decoded
+		if (lengths[256] == 0) return false;
+
+		int err = Construct(lencode, lengths, nlen);
+		if (err < 0 || (err > 0 && nlen - lencode.count[0] != 1)) return false;
+		err = Construct(distcode, lengths + nlen, ndist);
+		if (err < 0 || (err > 0 && ndist - distcode.count[0] != 1)) return false;
+
+		return Codes(lencode, distcode);
+	}
+
+private:
+	const uint8_t* in;
+	size_t inLen;
+	size_t inPos = 0;
+	uint32_t bitBuf = 0;
+	int bitCnt = 0;
+	bool bError = false;
+	std::vector<uint8_t>& out;
+};
+
+bool olc::Inflate(const uint8_t* pIn, size_t nIn, std::vector<uint8_t>& vOut)
+{
+	olc_Inflater inflater(pIn, nIn, vOut);
+	return inflater.Run();
+}
+
+uint32_t olc::Crc32(const uint8_t* pData, size_t nSize)
+{
+	static const std::array<uint32_t, 256> table = []()
+	{
+		std::array<uint32_t, 256> t;
+		for (uint32_t i = 0; i < 256; i++)
+		{
+			uint32_t c = i;
+			for (int k = 0; k < 8; k++) c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+			t[i] = c;
+		}
+		return t;
+	}();
+
+	uint32_t crc = 0xFFFFFFFFu;
+	for (size_t i = 0; i < nSize; i++)
+		crc = table[(crc ^ pData[i]) & 0xFF] ^ (crc >> 8);
+	return crc ^ 0xFFFFFFFFu;
+}
+
+bool olc::ZipArchive::Open(const uint8_t* data, size_t size)
+{
+	Close();
+	if (data == nullptr || size < 22) return false;
+
+	// The end of central directory record is last in the file, followed only by an optional comment
+	size_t eocd = size - 22;
+	size_t stop = size > 22 + 0xFFFF ? size - 22 - 0xFFFF : 0;
+	while (Read32(data + eocd) != 0x06054B50)
+	{
+		if (eocd == stop) return false;
+		eocd--;
+	}
+
+	uint16_t count = Read16(data + eocd + 10);
+	uint32_t cdSize = Read32(data + eocd + 12);
+	uint32_t cdOffset = Read32(data + eocd + 16);
+	if (uint64_t(cdOffset) + cdSize > size) return false;
+
+	size_t p = cdOffset;
+	for (uint16_t i = 0; i < count; i++)
+	{
+		if (p + 46 > size || Read32(data + p) != 0x02014B50) { Close(); return false; }
+
+		Entry e;
+		e.method = Read16(data + p + 10);
+		e.crc = Read32(data + p + 16);
+		e.compressedSize = Read32(data + p + 20);
+		e.size = Read32(data + p + 24);
+		e.localOffset = Read32(data + p + 42);
+		uint16_t nameLength = Read16(data + p + 28);
+		uint16_t extraLength = Read16(data + p + 30);
+		uint16_t commentLength = Read16(data + p + 32);
+		if (p + 46 + nameLength > size) { Close(); return false; }
+
+		mapEntries[std::string((const char*)data + p + 46, nameLength)] = e;
+		p += 46 + nameLength + extraLength + commentLength;
+	}
+
+	pData = data;
+	nSize = size;
+	return true;
+}
+
+void olc::ZipArchive::Close()
+{
+	mapEntries.clear();
+	pData = nullptr;
+	nSize = 0;
+}
+
+bool olc::ZipArchive::Extract(const std::string& sName, std::vector<uint8_t>& vOut) const
+{
+	vOut.clear();
+	auto it = mapEntries.find(sName);
+	if (it == mapEntries.end()) return false;
+	const Entry& e = it->second;
+
+	// The local header repeats the name and may carry a different extra field
+	size_t lh = e.localOffset;
+	if (lh + 30 > nSize || Read32(pData + lh) != 0x04034B50) return false;
+	size_t start = lh + 30 + Read16(pData + lh + 26) + Read16(pData + lh + 28);
+	if (uint64_t(start) + e.compressedSize > nSize) return false;
+
+	vOut.reserve(e.size);
+	if (e.method == 0)
+		vOut.assign(pData + start, pData + start + e.compressedSize);
+	else if (e.method == 8)
+	{
+		if (!olc::Inflate(pData + start, e.compressedSize, vOut)) return false;
+	}
+	else
+		return false;
+
+	return vOut.size() == e.size && olc::Crc32(vOut.data(), vOut.size()) == e.crc;
+}
+
+bool olc::PyxelMap::Load(const std::string& sFile, const std::string& sTileSheet)
+{
+	auto hasExtension = [&sFile](const std::string& ext)
+	{ return sFile.size() >= ext.size() && sFile.compare(sFile.size() - ext.size(), ext.size(), ext) == 0; };
+
+	if (hasExtension(".jmap"))
+		return LoadFromBinary(sFile);
+	if (hasExtension(".pyxel"))
+		return LoadFromPyxel(sFile);
+	// Finding the layers costs a pass over the file, only worth it with cores to spread them over
+	if (std::thread::hardware_concurrency() > 1)
+		return LoadFromJsonParallel(sFile, sTileSheet);
+	return LoadFromJson(sFile, sTileSheet);
+}
+
+std::string olc::PyxelMap::CachePath(const std::string& sFile, const std::string& sCacheDir, const std::string& sTileSheet)
+{
+	MappedFile file;
+	if (!file.Open(sFile))
+		return "";
+
+	// FNV-1a over 64-bit words, the tail is padded with zeros
+	uint64_t hash = 0xCBF29CE484222325ull;
+	auto mix = [&hash](uint64_t word) { hash = (hash ^ word) * 0x100000001B3ull; };
+	mix(LOADER_VERSION);
+	mix(BINARY_VERSION);
+	mix(file.Size());
+	for (char c : sTileSheet)
+		mix(uint8_t(c));
+
+	const uint8_t* p = file.Data();
+	size_t n = file.Size();
+	for (; n >= 8; p += 8, n -= 8)
+	{
+		uint64_t word;
+		std::memcpy(&word, p, 8);
+		mix(word);
+	}
+	uint64_t tail = 0;
+	std::memcpy(&tail, p, n);
+	mix(tail);
+
+	char hex[17];
+	snprintf(hex, sizeof(hex), "%016llx", (unsigned long long)hash);
+	return (_gfs::path(sCacheDir) / (_gfs::path(sFile).stem().string() + "-" + hex + ".jmap")).string();
+}
+
+bool olc::PyxelMap::LoadCached(const std::string& sFile, const std::string& sCacheDir, const std::string& sTileSheet)
+{
+	// Compiled maps don't need it, and a .pyxel needs its archive for the tiles either way
+	auto hasExtension = [&sFile](const std::string& ext)
+	{ return sFile.size() >= ext.size() && sFile.compare(sFile.size() - ext.size(), ext.size(), ext) == 0; };
+	if (hasExtension(".jmap") || hasExtension(".pyxel"))
+		return Load(sFile, sTileSheet);
+
+	std::string sCache = CachePath(sFile, sCacheDir, sTileSheet);
+	if (sCache.empty())
+		return false;
+	if (LoadFromBinary(sCache))
+		return true;
+
+	if (!Load(sFile, sTileSheet))
+		return false;
+
+	// Entries for older versions of this map are never hit again, replace them
+	std::error_code ec;
+	_gfs::create_directories(sCacheDir, ec);
+	std::string sPrefix = _gfs::path(sFile).stem().string() + "-";
+	std::vector<_gfs::path> vStale;
+	for (auto& entry : _gfs::directory_iterator(sCacheDir, ec))
+	{
+		std::string sName = entry.path().filename().string();
+		if (sName.size() == sPrefix.size() + 21 && sName.compare(0, sPrefix.size(), sPrefix) == 0 && entry.path().extension() == ".jmap")
+			vStale.push_back(entry.path());
+	}
+	for (auto& path : vStale)
+		_gfs::remove(path, ec);
+
+	// Failing to write the cache only costs the next launch a parse
+	SaveToBinary(sCache);
+	return true;
+}
+
+void olc::PyxelMap::Clear()
+{
+	vLayers.clear();
+	vLayerStorage.clear();
+	archive.Close();
+	mappedFile.Close();
+	vMapSize = { 0, 0 };
+	vTileSize = { 0, 0 };
+	sTileSheet.clear();
+	vTileSheetSize = { 0, 0 };
+	nTileSheetColumns = 0;
+	nTileCount = 0;
+}
+
+bool olc::PyxelMap::LoadFromJson(const std::string& sFile, const std::string& sTileSheetFile)
+{
+	Clear();
+
+	std::ifstream i(sFile);
+	if (!i.is_open()) return false;
+
+	JsonSaxHandler handler(*this);
+	if (!nlohmann::json::sax_parse(i, &handler) || !handler.Finish())
+	{
+		Clear();
+		return false;
+	}
+
+	sTileSheet = sTileSheetFile;
+	return true;
+}
+
+bool olc::PyxelMap::FindJsonLayers(const char* p, size_t n, size_t& nArrayBegin, size_t& nArrayEnd,
+	std::vector<std::pair<size_t, size_t>>& vLayerRanges)
+{
+	// Only brackets and strings are looked at, strings are skipped as a whole so a
+	// bracket inside a layer name can't throw the depth off
+	int depth = 0;
+	size_t keyBegin = 0, keyEnd = 0, layerBegin = 0;
+	bool bInLayers = false;
+	nArrayBegin = nArrayEnd = 0;
+	vLayerRanges.clear();
+
+	for (size_t i = 0; i < n; i++)
+	{
+		char c = p[i];
+		if (c == '"')
+		{
+			size_t begin = ++i;
+			while (i < n && p[i] != '"')
+				i += p[i] == '\\' ? 2 : 1;
+			if (i >= n) return false;
+			if (depth == 1) { keyBegin = begin; keyEnd = i; }
+		}
+		else if (c == '{' || c == '[')
+		{
+			if (depth == 1 && c == '[' && !bInLayers && nArrayEnd == 0 && keyEnd - keyBegin == 6 && std::memcmp(p + keyBegin, "layers", 6) == 0)
+			{
+				bInLayers = true;
+				nArrayBegin = i;
+			}
+			else if (bInLayers && depth == 2 && c == '{')
+				layerBegin = i;
+			depth++;
+		}
+		else if (c == '}' || c == ']')
+		{
+			if (--depth < 0) return false;
+			if (bInLayers && depth == 2 && c == '}')
+				vLayerRanges.push_back({ layerBegin, i + 1 });
+			else if (bInLayers && depth == 1 && c == ']')
+			{
+				bInLayers = false;
+				nArrayEnd = i;
+			}
+		}
+	}
+	return depth == 0 && nArrayEnd > nArrayBegin;
+}
+
+bool olc::PyxelMap::LoadFromJsonParallel(const std::string& sFile, const std::string& sTileSheetFile, int nThreads)
+{
+	Clear();
+
+	MappedFile file;
+	if (!file.Open(sFile)) return false;
+	const char* p = reinterpret_cast<const char*>(file.Data());
+
+	size_t nArrayBegin, nArrayEnd;
+	std::vector<std::pair<size_t, size_t>> vRanges;
+	if (!FindJsonLayers(p, file.Size(), nArrayBegin, nArrayEnd, vRanges))
+		return false;
+
+	// Everything but the layers is only a handful of numbers, parse it with the layer array emptied
+	std::string sRoot = std::string(p, nArrayBegin + 1) + std::string(p + nArrayEnd, file.Size() - nArrayEnd);
+	JsonSaxHandler root(*this);
+	if (!nlohmann::json::sax_parse(sRoot, &root) || !root.PlaceTiles())
+		return false;
+
+	std::vector<std::unique_ptr<JsonSaxHandler>> vHandlers;
+	for (size_t l = 0; l < vRanges.size(); l++)
+		vHandlers.push_back(std::make_unique<JsonSaxHandler>(*this, root.MapSize(), root.TileSize()));
+
+	// Each thread takes the next layer that nobody has started on
+	std::atomic<size_t> nNextLayer{ 0 };
+	std::atomic<bool> bFailed{ false };
+	auto worker = [&]()
+	{
+		for (size_t l = nNextLayer++; l < vRanges.size(); l = nNextLayer++)
+		{
+			const char* first = p + vRanges[l].first;
+			const char* last = p + vRanges[l].second;
+			if (!nlohmann::json::sax_parse(first, last, vHandlers[l].get()) || !vHandlers[l]->PlaceTiles())
+				bFailed = true;
+		}
+	};
+
+	if (nThreads <= 0)
+		nThreads = std::max(1, int(std::thread::hardware_concurrency()));
+	nThreads = std::min(nThreads, std::max(1, int(vRanges.size())));
+
+	std::vector<std::thread> vPool;
+	for (int t = 1; t < nThreads; t++)
+		vPool.emplace_back(worker);
+	worker();
+	for (auto& t : vPool)
+		t.join();
+
+	if (bFailed)
+	{
+		Clear();
+		return false;
+	}
+
+	// Merge in document order no matter which thread finished first
+	root.Commit();
+	for (auto& handler : vHandlers)
+		handler->Commit();
+
+	sTileSheet = sTileSheetFile;
+	return true;
+}
+
+const nlohmann::json* olc::PyxelMap::JsonMember(const nlohmann::json& j, const char* sKey, nlohmann::json::value_t type)
+{
+	if (!j.is_object()) return nullptr;
+	auto it = j.find(sKey);
+	return it != j.end() && it->type() == type ? &*it : nullptr;
+}
+
+bool olc::PyxelMap::JsonInt(const nlohmann::json& j, const char* sKey, int& n)
+{
+	if (!j.is_object()) return false;
+	auto it = j.find(sKey);
+	if (it == j.end() || !it->is_number_integer()) return false;
+	n = it->get<int>();
+	return true;
+}
+
+bool olc::PyxelMap::JsonIndex(const std::string& sKey, size_t& n)
+{
+	const char* pEnd = sKey.data() + sKey.size();
+	auto result = std::from_chars(sKey.data(), pEnd, n);
+	return !sKey.empty() && result.ec == std::errc() && result.ptr == pEnd;
+}
+
+bool olc::PyxelMap::LoadFromJsonDom(const std::string& sFile, const std::string& sTileSheetFile)
+{
+	Clear();
+
+	std::ifstream i(sFile);
+	if (!i.is_open()) return false;
+
+	nlohmann::json j = nlohmann::json::parse(i, nullptr, false);
+	if (j.is_discarded()) return false;
+
+	// Same checks as the streaming loader, a map without sizes or layers doesn't load
+	const nlohmann::json* layers = JsonMember(j, "layers", nlohmann::json::value_t::array);
+	if (!JsonInt(j, "tileswide", vMapSize.x) || !JsonInt(j, "tileshigh", vMapSize.y) ||
+		!JsonInt(j, "tilewidth", vTileSize.x) || !JsonInt(j, "tileheight", vTileSize.y) || layers == nullptr ||
+		vMapSize.x <= 0 || vMapSize.y <= 0 || vTileSize.x <= 0 || vTileSize.y <= 0)
+	{
+		Clear();
+		return false;
+	}
+	sTileSheet = sTileSheetFile;
+
+	for (auto& layer : *layers)
+	{
+		const nlohmann::json* name = JsonMember(layer, "name", nlohmann::json::value_t::string);
+		const nlohmann::json* tiles = JsonMember(layer, "tiles", nlohmann::json::value_t::array);
+		if (name == nullptr || tiles == nullptr)
+		{
+			Clear();
+			return false;
+		}
+
+		std::vector<uint16_t> grid(size_t(vMapSize.x) * size_t(vMapSize.y), EMPTY_TILE);
+		for (auto& tile : *tiles)
+		{
+			// Pyxel writes -1 for cells without a tile
+			int tileID, x, y;
+			if (!JsonInt(tile, "tile", tileID) || !JsonInt(tile, "x", x) || !JsonInt(tile, "y", y))
+			{
+				Clear();
+				return false;
+			}
+			if (tileID == -1)
+				continue;
+
+			if (x < 0 || y < 0 || x >= vMapSize.x || y >= vMapSize.y)
+				continue;
+			grid[size_t(y) * vMapSize.x + x] = uint16_t(tileID);
+		}
+
+		vLayerStorage.push_back(std::move(grid));
+		vLayers.push_back({ name->get<std::string>(), vLayerStorage.back().data() });
+	}
+	return true;
+}
+
+bool olc::PyxelMap::LoadFromBinary(const std::string& sFile)
+{
+	Clear();
+
+	if (!mappedFile.Open(sFile)) return false;
+	const uint8_t* data = mappedFile.Data();
+	const size_t size = mappedFile.Size();
+
+	auto inBounds = [&](uint64_t offset, uint64_t length) { return offset + length <= size; };
+
+	if (!inBounds(0, sizeof(BinaryHeader))) { Clear(); return false; }
+	BinaryHeader header;
+	std::memcpy(&header, data, sizeof(BinaryHeader));
+
+	const uint64_t nTiles = uint64_t(header.tilesWide) * header.tilesHigh;
+	if (header.magic != BINARY_MAGIC || header.version != BINARY_VERSION ||
+		!inBounds(sizeof(BinaryHeader), uint64_t(header.layerCount) * sizeof(BinaryLayer)) ||
+		!inBounds(header.tileSheetOffset, header.tileSheetLength))
+	{
+		Clear();
+		return false;
+	}
+
+	vMapSize = { int32_t(header.tilesWide), int32_t(header.tilesHigh) };
+	vTileSize = { int32_t(header.tileWidth), int32_t(header.tileHeight) };
+	sTileSheet.assign((const char*)data + header.tileSheetOffset, header.tileSheetLength);
+
+	const uint8_t* layerTable = data + sizeof(BinaryHeader);
+	for (uint32_t l = 0; l < header.layerCount; l++)
+	{
+		BinaryLayer bl;
+		std::memcpy(&bl, layerTable + l * sizeof(BinaryLayer), sizeof(BinaryLayer));
+
+		// Grids are written 2 byte aligned so they can be used straight from the mapping
+		if (!inBounds(bl.nameOffset, bl.nameLength) || !inBounds(bl.tilesOffset, nTiles * sizeof(uint16_t)) || (bl.tilesOffset & 1))
+		{
+			Clear();
+			return false;
+		}
+
+		Layer layer;
+		layer.name.assign((const char*)data + bl.nameOffset, bl.nameLength);
+		layer.tiles = (const uint16_t*)(data + bl.tilesOffset);
+		vLayers.push_back(std::move(layer));
+	}
+	return true;
+}
+
+bool olc::PyxelMap::LoadFromPyxel(const std::string& sFile)
+{
+	Clear();
+
+	std::vector<uint8_t> doc;
+	if (!mappedFile.Open(sFile) || !archive.Open(mappedFile.Data(), mappedFile.Size()) || !archive.Extract("docData.json", doc))
+	{
+		Clear();
+		return false;
+	}
+
+	nlohmann::json j = nlohmann::json::parse(doc.begin(), doc.end(), nullptr, false);
+	if (j.is_discarded()) { Clear(); return false; }
+	doc = std::vector<uint8_t>();
+
+	const nlohmann::json* canvas = JsonMember(j, "canvas", nlohmann::json::value_t::object);
+	const nlohmann::json* tileset = JsonMember(j, "tileset", nlohmann::json::value_t::object);
+	const nlohmann::json* layers = canvas ? JsonMember(*canvas, "layers", nlohmann::json::value_t::object) : nullptr;
+	int nWidth, nHeight;
+	if (layers == nullptr || tileset == nullptr ||
+		!JsonInt(*canvas, "tileWidth", vTileSize.x) || !JsonInt(*canvas, "tileHeight", vTileSize.y) ||
+		!JsonInt(*canvas, "width", nWidth) || !JsonInt(*canvas, "height", nHeight) ||
+		!JsonInt(*tileset, "tilesWide", nTileSheetColumns) || !JsonInt(*tileset, "numTiles", nTileCount) ||
+		vTileSize.x <= 0 || vTileSize.y <= 0)
+	{
+		Clear();
+		return false;
+	}
+	vMapSize = { nWidth / vTileSize.x, nHeight / vTileSize.y };
+	if (vMapSize.x <= 0 || vMapSize.y <= 0) { Clear(); return false; }
+
+	// Layers are keyed by number with "0" on top, the export lists them
+	// bottom first so we do the same to keep the draw order
+	std::vector<std::pair<size_t, const nlohmann::json*>> order;
+	for (auto& layer : layers->items())
+	{
+		size_t number;
+		if (!JsonIndex(layer.key(), number)) { Clear(); return false; }
+		order.push_back({ number, &layer.value() });
+	}
+	std::sort(order.begin(), order.end(), [](const auto& a, const auto& b) { return a.first > b.first; });
+
+	const size_t nTiles = size_t(vMapSize.x) * size_t(vMapSize.y);
+	for (auto& numbered : order)
+	{
+		const nlohmann::json& layer = *numbered.second;
+		const nlohmann::json* name = JsonMember(layer, "name", nlohmann::json::value_t::string);
+		const nlohmann::json* refs = JsonMember(layer, "tileRefs", nlohmann::json::value_t::object);
+		if (name == nullptr || refs == nullptr) { Clear(); return false; }
+		std::vector<uint16_t> grid(nTiles, EMPTY_TILE);
+
+		// Only cells holding a tile are stored, keyed by their row-major index
+		for (auto& ref : refs->items())
+		{
+			size_t cell;
+			int tileID;
+			if (!JsonIndex(ref.key(), cell) || !JsonInt(ref.value(), "index", tileID)) { Clear(); return false; }
+			if (cell < nTiles && tileID >= 0 && tileID < EMPTY_TILE)
+				grid[cell] = uint16_t(tileID);
+		}
+
+		vLayerStorage.push_back(std::move(grid));
+		vLayers.push_back({ name->get<std::string>(), vLayerStorage.back().data() });
+	}
+
+	// Tile 0 is Pyxel's empty tile and is left out of the sheet, same as the tilesheet export
+	nTileSheetColumns = std::max(1, nTileSheetColumns);
+	int rows = std::max(1, (nTileCount - 1 + nTileSheetColumns - 1) / nTileSheetColumns);
+	vTileSheetSize = { nTileSheetColumns * vTileSize.x, rows * vTileSize.y };
+	return true;
+}
+
+bool olc::PyxelMap::BuildTileSheet(olc::Sprite* spr) const
+{
+	if (!HasArchiveTileSheet() || spr == nullptr || spr->width != vTileSheetSize.x || spr->height != vTileSheetSize.y)
+		return false;
+
+	std::vector<uint8_t> png;
+	for (int id = 1; id < nTileCount; id++)
+	{
+		if (!archive.Extract("tile" + std::to_string(id) + ".png", png))
+			continue;
+
+		olc::Sprite tile;
+		if (tile.LoadFromMemory(png.data(), png.size()) != olc::OK)
+			continue;
+
+		// Same layout the game expects from the exported tilesheet, tile id N sits in slot N - 1
+		int slot = id - 1;
+		int ox = (slot % nTileSheetColumns) * vTileSize.x;
+		int oy = (slot / nTileSheetColumns) * vTileSize.y;
+		for (int y = 0; y < std::min(tile.height, vTileSize.y); y++)
+			for (int x = 0; x < std::min(tile.width, vTileSize.x); x++)
+				spr->SetPixel(ox + x, oy + y, tile.GetPixel(x, y));
+	}
+	return true;
+}
+
+bool olc::PyxelMap::Diff(const PyxelMap& other, std::vector<TileChange>& vChanges) const
+{
+	vChanges.clear();
+	if (vMapSize.x != other.vMapSize.x || vMapSize.y != other.vMapSize.y ||
+		vTileSize.x != other.vTileSize.x || vTileSize.y != other.vTileSize.y ||
+		vLayers.size() != other.vLayers.size())
+		return false;
+	for (size_t l = 0; l < vLayers.size(); l++)
+		if (vLayers[l].name != other.vLayers[l].name)
+			return false;
+
+	// Most rows don't change between two saves, compare whole rows first
+	const size_t nRow = size_t(vMapSize.x);
+	for (size_t l = 0; l < vLayers.size(); l++)
+		for (size_t y = 0; y < size_t(vMapSize.y); y++)
+		{
+			const uint16_t* a = vLayers[l].tiles + y * nRow;
+			const uint16_t* b = other.vLayers[l].tiles + y * nRow;
+			if (std::memcmp(a, b, nRow * sizeof(uint16_t)) == 0)
+				continue;
+			for (size_t x = 0; x < nRow; x++)
+				if (a[x] != b[x])
+					vChanges.push_back({ uint16_t(l), uint32_t(y * nRow + x), a[x], b[x] });
+		}
+	return true;
+}
+
+bool olc::PyxelMap::SaveToBinary(const std::string& sFile) const
+{
+	// Write next to the target and rename over it, a game that has the old
+	// file mapped keeps reading the old data instead of a half written file
+	const std::string sTemp = sFile + ".tmp";
+	if (!WriteBinary(sTemp))
+	{
+		std::remove(sTemp.c_str());
+		return false;
+	}
+
+	std::error_code ec;
+	_gfs::rename(sTemp, sFile, ec);
+	if (ec)
+	{
+		std::remove(sTemp.c_str());
+		return false;
+	}
+	return true;
+}
+
+bool olc::PyxelMap::WriteBinary(const std::string& sFile) const
+{
+	std::ofstream ofs(sFile, std::ofstream::binary);
+	if (!ofs.is_open()) return false;
+
+	const size_t nTiles = size_t(vMapSize.x) * size_t(vMapSize.y);
+
+	BinaryHeader header;
+	header.magic = BINARY_MAGIC;
+	header.version = BINARY_VERSION;
+	header.tilesWide = uint32_t(vMapSize.x);
+	header.tilesHigh = uint32_t(vMapSize.y);
+	header.tileWidth = uint32_t(vTileSize.x);
+	header.tileHeight = uint32_t(vTileSize.y);
+	header.layerCount = uint32_t(vLayers.size());
+
+	// Strings go straight after the layer table, then the tile grids
+	uint32_t offset = uint32_t(sizeof(BinaryHeader) + vLayers.size() * sizeof(BinaryLayer));
+	header.tileSheetOffset = offset;
+	header.tileSheetLength = uint32_t(sTileSheet.size());
+	offset += header.tileSheetLength;
+
+	std::vector<BinaryLayer> table(vLayers.size());
+	for (size_t l = 0; l < vLayers.size(); l++)
+	{
+		table[l].nameOffset = offset;
+		table[l].nameLength = uint32_t(vLayers[l].name.size());
+		table[l].reserved = 0;
+		offset += table[l].nameLength;
+	}
+
+	auto align = [](uint32_t n) { return (n + 3u) & ~3u; };
+	offset = align(offset);
+	for (auto& bl : table)
+	{
+		bl.tilesOffset = offset;
+		offset = align(offset + uint32_t(nTiles * sizeof(uint16_t)));
+	}
+
+	auto pad = [&ofs, &align]()
+	{
+		uint32_t pos = uint32_t(ofs.tellp());
+		for (uint32_t i = pos; i < align(pos); i++) ofs.put(0);
+	};
+
+	ofs.write((const char*)&header, sizeof(BinaryHeader));
+	ofs.write((const char*)table.data(), table.size() * sizeof(BinaryLayer));
+	ofs.write(sTileSheet.data(), sTileSheet.size());
+	for (auto& layer : vLayers)
+		ofs.write(layer.name.data(), layer.name.size());
+	pad();
+	for (auto& layer : vLayers)
+	{
+		ofs.write((const char*)layer.tiles, nTiles * sizeof(uint16_t));
+		pad();
+	}
+	return ofs.good();
+}
+
+#endif
@@ -0,0 +1,291 @@
+/*
+	olcPGEX_SpatialHash.h
+
+	+-------------------------------------------------------------+
+	|         OneLoneCoder Pixel Game Engine Extension            |
+	|                SpatialHash - v1.0                           |
+	+-------------------------------------------------------------+
+
+	What is this?
+	~~~~~~~~~~~~~
+	This is an extension to the olcPixelGameEngine v2.0 and above.
+	It sorts objects with a rectangle into the cells of a uniform
+	grid, so finding what is near something only visits the cells
+	around it instead of every object there is:
+
+			olc::SpatialHash<Collider> grid({ 32.0f, 32.0f });
+			grid.Insert(&wall, wall.position, wall.size);
+
+			// Every frame
+			grid.Move(&monster, monster.position, monster.size);
+			grid.Query(player.position, player.size, [&](Collider* c)
+			{
+				...
+			});
+
+	Only cells that hold something are stored, so the grid can be as
+	large as the map and doesn't have to be sized up front. A query
+	calls back every object whose cells touch the queried rectangle,
+	once each even when both span several cells. Whether they really
+	overlap is up to the callback.
+
+	Objects are only known by their address, it has to stay the same
+	while they are in the grid.
+
+	SweepCells walks the cells of a grid a moving rectangle passes, in
+	the order it gets to them, and stops at the first one the callback
+	says is in the way:
+
+			float t = olc::SweepCells(pos, size, step, { 32.0f, 32.0f },
+				[&](const olc::vi2d& cell) { return IsWall(cell); });
+			pos += step * t;
+
+	Author
+	~~~~~~
+	Frowsty
+
+*/
+
+#ifndef OLC_PGEX_SPATIALHASH
+#define OLC_PGEX_SPATIALHASH
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <unordered_map>
+#include <vector>
+
+namespace olc
+{
+	template<typename T>
+	class SpatialHash
+	{
+	public:
+		SpatialHash(const olc::vf2d& vCellSize = { 32.0f, 32.0f }) : vCellSize(vCellSize) {}
+
+		inline void Insert(T* pItem, const olc::vf2d& vPos, const olc::vf2d& vSize);
+		inline void Remove(T* pItem);
+		// Only touches the grid when the object ends up in other cells
+		inline void Move(T* pItem, const olc::vf2d& vPos, const olc::vf2d& vSize);
+		inline void Clear();
+
+		// Calls func(T*) for everything in the cells under the rectangle
+		template<typename Func>
+		inline void Query(const olc::vf2d& vPos, const olc::vf2d& vSize, Func func) const;
+
+		size_t Size() const { return mapItems.size(); }
+		size_t CellCount() const { return mapCells.size(); }
+
+	private:
+		struct Bounds
+		{
+			olc::vi2d vFirst;
+			olc::vi2d vLast;	// Inclusive
+		};
+
+		// An object as listed in a cell, the first cell it is in decides where a query reports it
+		struct Entry
+		{
+			T* pItem;
+			olc::vi2d vFirst;
+		};
+
+		inline Bounds CellsUnder(const olc::vf2d& vPos, const olc::vf2d& vSize) const;
+		inline void Link(T* pItem, const Bounds& b);
+		inline void Unlink(T* pItem, const Bounds& b);
+
+		static int64_t Key(int x, int y) { return int64_t(uint64_t(uint32_t(y)) << 32 | uint32_t(x)); }
+
+	private:
+		olc::vf2d vCellSize;
+		std::unordered_map<int64_t, std::vector<Entry>> mapCells;
+		std::unordered_map<T*, Bounds> mapItems;
+	};
+
+	// How much of the step the rectangle makes before touching a cell func(const olc::vi2d&) returns
+	// true for, 1 if it gets all the way and 0 if it starts on one
+	template<typename Func>
+	inline float SweepCells(const olc::vf2d& vPos, const olc::vf2d& vSize, const olc::vf2d& vStep, const olc::vf2d& vCellSize, Func func);
+}
+
+template<typename T>
+typename olc::SpatialHash<T>::Bounds olc::SpatialHash<T>::CellsUnder(const olc::vf2d& vPos, const olc::vf2d& vSize) const
+{
+	// The far edge is exclusive, a tile sized rectangle on the grid is in one cell
+	Bounds b;
+	b.vFirst = { int(std::floor(vPos.x / vCellSize.x)), int(std::floor(vPos.y / vCellSize.y)) };
+	b.vLast = { int(std::ceil((vPos.x + vSize.x) / vCellSize.x)) - 1, int(std::ceil((vPos.y + vSize.y) / vCellSize.y)) - 1 };
+	b.vLast = { std::max(b.vFirst.x, b.vLast.x), std::max(b.vFirst.y, b.vLast.y) };
+	return b;
+}
+
+template<typename T>
+void olc::SpatialHash<T>::Link(T* pItem, const Bounds& b)
+{
+	for (int y = b.vFirst.y; y <= b.vLast.y; y++)
+		for (int x = b.vFirst.x; x <= b.vLast.x; x++)
+			mapCells[Key(x, y)].push_back({ pItem, b.vFirst });
+}
+
+template<typename T>
+void olc::SpatialHash<T>::Unlink(T* pItem, const Bounds& b)
+{
+	for (int y = b.vFirst.y; y <= b.vLast.y; y++)
+		for (int x = b.vFirst.x; x <= b.vLast.x; x++)
+		{
+			auto it = mapCells.find(Key(x, y));
+			if (it == mapCells.end())
+				continue;
+
+			std::vector<Entry>& cell = it->second;
+			auto entry = std::find_if(cell.begin(), cell.end(), [&](const Entry& e) { return e.pItem == pItem; });
+			if (entry != cell.end())
+			{
+				*entry = cell.back();
+				cell.pop_back();
+			}
+			if (cell.empty())
+				mapCells.erase(it);
+		}
+}
+
+template<typename T>
+void olc::SpatialHash<T>::Insert(T* pItem, const olc::vf2d& vPos, const olc::vf2d& vSize)
+{
+	auto it = mapItems.find(pItem);
+	if (it != mapItems.end())
+	{
+		Move(pItem, vPos, vSize);
+		return;
+	}
+
+	Bounds b = CellsUnder(vPos, vSize);
+	mapItems.emplace(pItem, b);
+	Link(pItem, b);
+}
+
+template<typename T>
+void olc::SpatialHash<T>::Remove(T* pItem)
+{
+	auto it = mapItems.find(pItem);
+	if (it == mapItems.end())
+		return;
+
+	Unlink(pItem, it->second);
+	mapItems.erase(it);
+}
+
+template<typename T>
+void olc::SpatialHash<T>::Move(T* pItem, const olc::vf2d& vPos, const olc::vf2d& vSize)
+{
+	auto it = mapItems.find(pItem);
+	if (it == mapItems.end())
+	{
+		Insert(pItem, vPos, vSize);
+		return;
+	}
+
+	Bounds b = CellsUnder(vPos, vSize);
+	const Bounds& old = it->second;
+	if (b.vFirst.x == old.vFirst.x && b.vFirst.y == old.vFirst.y && b.vLast.x == old.vLast.x && b.vLast.y == old.vLast.y)
+		return;
+
+	Unlink(pItem, it->second);
+	it->second = b;
+	Link(pItem, b);
+}
+
+template<typename T>
+void olc::SpatialHash<T>::Clear()
+{
+	mapCells.clear();
+	mapItems.clear();
+}
+
+template<typename Func>
+float olc::SweepCells(const olc::vf2d& vPos, const olc::vf2d& vSize, const olc::vf2d& vStep, const olc::vf2d& vCellSize, Func func)
+{
+	// The cells from lo to hi on one axis right after this moment, an edge on a cell border only
+	// counts as in the next cell when it's moving into it
+	auto span = [](float lo, float hi, float move, float cell)
+	{
+		if (move > 0.0f)
+			return std::make_pair(int(std::floor(lo / cell)), int(std::floor(hi / cell)));
+		if (move < 0.0f)
+			return std::make_pair(int(std::ceil(lo / cell)) - 1, int(std::ceil(hi / cell)) - 1);
+		return std::make_pair(int(std::floor(lo / cell)), int(std::ceil(hi / cell)) - 1);
+	};
+	auto blocked = [&](std::pair<int, int> columns, std::pair<int, int> rows)
+	{
+		for (int y = rows.first; y <= rows.second; y++)
+			for (int x = columns.first; x <= columns.second; x++)
+				if (func(olc::vi2d(x, y)))
+					return true;
+		return false;
+	};
+
+	olc::vf2d vMin = vPos, vMax = vPos + vSize;
+	if (blocked(span(vMin.x, vMax.x, 0.0f, vCellSize.x), span(vMin.y, vMax.y, 0.0f, vCellSize.y)))
+		return 0.0f;
+
+	// The edge in front on each axis crosses into a new column or row of cells every delta of the step
+	const float fNever = std::numeric_limits<float>::infinity();
+	olc::vf2d vNext = { fNever, fNever }, vDelta = { fNever, fNever };
+	olc::vi2d vCell = { 0, 0 }, vDir = { vStep.x > 0.0f ? 1 : -1, vStep.y > 0.0f ? 1 : -1 };
+	if (vStep.x != 0.0f)
+	{
+		vCell.x = vStep.x > 0.0f ? int(std::ceil(vMax.x / vCellSize.x)) : int(std::floor(vMin.x / vCellSize.x)) - 1;
+		vNext.x = ((vStep.x > 0.0f ? vCell.x : vCell.x + 1) * vCellSize.x - (vStep.x > 0.0f ? vMax.x : vMin.x)) / vStep.x;
+		vDelta.x = vCellSize.x / std::abs(vStep.x);
+	}
+	if (vStep.y != 0.0f)
+	{
+		vCell.y = vStep.y > 0.0f ? int(std::ceil(vMax.y / vCellSize.y)) : int(std::floor(vMin.y / vCellSize.y)) - 1;
+		vNext.y = ((vStep.y > 0.0f ? vCell.y : vCell.y + 1) * vCellSize.y - (vStep.y > 0.0f ? vMax.y : vMin.y)) / vStep.y;
+		vDelta.y = vCellSize.y / std::abs(vStep.y);
+	}
+
+	// Only the newly entered column or row has to be looked at, over the part of it the rectangle covers by then
+	while (std::min(vNext.x, vNext.y) < 1.0f)
+	{
+		if (vNext.x <= vNext.y)
+		{
+			float t = vNext.x;
+			if (blocked({ vCell.x, vCell.x }, span(vMin.y + vStep.y * t, vMax.y + vStep.y * t, vStep.y, vCellSize.y)))
+				return t;
+			vCell.x += vDir.x;
+			vNext.x += vDelta.x;
+		}
+		else
+		{
+			float t = vNext.y;
+			if (blocked(span(vMin.x + vStep.x * t, vMax.x + vStep.x * t, vStep.x, vCellSize.x), { vCell.y, vCell.y }))
+				return t;
+			vCell.y += vDir.y;
+			vNext.y += vDelta.y;
+		}
+	}
+	return 1.0f;
+}
+
+template<typename T>
+template<typename Func>
+void olc::SpatialHash<T>::Query(const olc::vf2d& vPos, const olc::vf2d& vSize, Func func) const
+{
+	Bounds q = CellsUnder(vPos, vSize);
+	for (int y = q.vFirst.y; y <= q.vLast.y; y++)
+		for (int x = q.vFirst.x; x <= q.vLast.x; x++)
+		{
+			auto it = mapCells.find(Key(x, y));
+			if (it == mapCells.end())
+				continue;
+
+			// Something spanning several of the queried cells is only reported from the first of them
+			for (const Entry& e : it->second)
+				if (x == std::max(q.vFirst.x, e.vFirst.x) && y == std::max(q.vFirst.y, e.vFirst.y))
+					func(e.pItem);
+		}
+}
+
+#endif
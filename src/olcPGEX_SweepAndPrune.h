@@ -0,0 +1,247 @@
+/*
+	olcPGEX_SweepAndPrune.h
+
+	+-------------------------------------------------------------+
+	|         OneLoneCoder Pixel Game Engine Extension            |
+	|                SweepAndPrune - v1.0                         |
+	+-------------------------------------------------------------+
+
+	What is this?
+	~~~~~~~~~~~~~
+	This is an extension to the olcPixelGameEngine v2.0 and above.
+	It finds which of a lot of moving rectangles overlap, without
+	testing every one against every other one:
+
+			olc::SweepAndPrune<Body> broadphase;
+			auto h = broadphase.Add(body, position, size, MONSTER, PROJECTILE);
+
+			// Every frame
+			broadphase.Move(h, position, size);
+			broadphase.FindPairs([&](Body& a, Body& b)
+			{
+				...
+			});
+
+	The rectangles are kept sorted by their left edge. Only the ones
+	that start before another one ends on that axis are tested on the
+	other, so mostly neighbours are. Things only move a little from
+	one frame to the next, the order of the last frame is nearly right
+	and an insertion sort puts it back in order with a few swaps.
+
+	Every rectangle has a category and the categories it collides
+	with, both bit masks. A pair is only reported when one of the two
+	collides with the other's category, a rectangle with neither is
+	left out altogether.
+
+	PairsTested() and Overlaps() tell how many pairs made it past the
+	sweep and the categories in the last FindPairs, and how many of
+	those really overlapped.
+
+	Removing one only marks it, it is taken out of the order on the
+	next FindPairs so removing many doesn't shift the order every time.
+	Its handle isn't given out again before then.
+
+	Nothing may be added or removed while FindPairs runs.
+
+	Author
+	~~~~~~
+	Frowsty
+
+*/
+
+#ifndef OLC_PGEX_SWEEPANDPRUNE
+#define OLC_PGEX_SWEEPANDPRUNE
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+namespace olc
+{
+	template<typename T>
+	class SweepAndPrune
+	{
+	public:
+		using Handle = uint32_t;
+
+		inline Handle Add(const T& item, const olc::vf2d& vPos, const olc::vf2d& vSize, uint32_t nCategory, uint32_t nCollidesWith);
+		inline void Remove(Handle h);
+		inline void Move(Handle h, const olc::vf2d& vPos, const olc::vf2d& vSize);
+		inline void SetFilter(Handle h, uint32_t nCategory, uint32_t nCollidesWith);
+		inline void Clear();
+
+		// Calls func(T&, T&) for every overlapping pair whose categories collide
+		template<typename Func>
+		inline void FindPairs(Func func);
+
+		T& Get(Handle h) { return vProxies[h].item; }
+		size_t Size() const { return vOrder.size() - nRemoved; }
+		size_t PairsTested() const { return nPairsTested; }
+		size_t Overlaps() const { return nOverlaps; }
+
+	private:
+		struct Proxy
+		{
+			T item;
+			olc::vf2d vMin;
+			olc::vf2d vMax;
+			uint32_t nCategory = 0;
+			uint32_t nCollidesWith = 0;
+			bool bRemoved = false;
+		};
+
+		inline void Compact();
+		inline void Sort();
+
+	private:
+		std::vector<Proxy> vProxies;
+		std::vector<Handle> vFree;
+		// Handles of everything added, by left edge
+		std::vector<Handle> vOrder;
+		bool bResort = false;
+		// Still in vOrder until the next Compact
+		size_t nRemoved = 0;
+		size_t nPairsTested = 0;
+		size_t nOverlaps = 0;
+	};
+}
+
+template<typename T>
+typename olc::SweepAndPrune<T>::Handle olc::SweepAndPrune<T>::Add(const T& item, const olc::vf2d& vPos, const olc::vf2d& vSize,
+	uint32_t nCategory, uint32_t nCollidesWith)
+{
+	Handle h;
+	if (!vFree.empty())
+	{
+		h = vFree.back();
+		vFree.pop_back();
+	}
+	else
+	{
+		h = Handle(vProxies.size());
+		vProxies.emplace_back();
+	}
+
+	vProxies[h] = { item, vPos, vPos + vSize, nCategory, nCollidesWith };
+	vOrder.push_back(h);
+	// Could be anywhere in the order, the next sort can't count on it being nearly right
+	bResort = true;
+	return h;
+}
+
+template<typename T>
+void olc::SweepAndPrune<T>::Remove(Handle h)
+{
+	if (h >= vProxies.size() || vProxies[h].bRemoved)
+		return;
+
+	// Without a category FindPairs skips it until it's gone from the order
+	vProxies[h].nCategory = 0;
+	vProxies[h].nCollidesWith = 0;
+	vProxies[h].bRemoved = true;
+	nRemoved++;
+}
+
+template<typename T>
+void olc::SweepAndPrune<T>::Move(Handle h, const olc::vf2d& vPos, const olc::vf2d& vSize)
+{
+	vProxies[h].vMin = vPos;
+	vProxies[h].vMax = vPos + vSize;
+}
+
+template<typename T>
+void olc::SweepAndPrune<T>::SetFilter(Handle h, uint32_t nCategory, uint32_t nCollidesWith)
+{
+	vProxies[h].nCategory = nCategory;
+	vProxies[h].nCollidesWith = nCollidesWith;
+}
+
+template<typename T>
+void olc::SweepAndPrune<T>::Clear()
+{
+	vProxies.clear();
+	vFree.clear();
+	vOrder.clear();
+	nRemoved = 0;
+	nPairsTested = 0;
+	nOverlaps = 0;
+}
+
+template<typename T>
+void olc::SweepAndPrune<T>::Compact()
+{
+	if (nRemoved == 0)
+		return;
+
+	// Keeps the order of the rest, so it's still nearly right for the insertion sort
+	size_t n = 0;
+	for (Handle h : vOrder)
+	{
+		if (vProxies[h].bRemoved)
+		{
+			vProxies[h] = Proxy();
+			vFree.push_back(h);
+		}
+		else
+			vOrder[n++] = h;
+	}
+	vOrder.resize(n);
+	nRemoved = 0;
+}
+
+template<typename T>
+void olc::SweepAndPrune<T>::Sort()
+{
+	auto left = [&](Handle a, Handle b) { return vProxies[a].vMin.x < vProxies[b].vMin.x; };
+	if (bResort)
+	{
+		std::sort(vOrder.begin(), vOrder.end(), left);
+		bResort = false;
+		return;
+	}
+
+	for (size_t i = 1; i < vOrder.size(); i++)
+	{
+		Handle h = vOrder[i];
+		size_t j = i;
+		for (; j > 0 && left(h, vOrder[j - 1]); j--)
+			vOrder[j] = vOrder[j - 1];
+		vOrder[j] = h;
+	}
+}
+
+template<typename T>
+template<typename Func>
+void olc::SweepAndPrune<T>::FindPairs(Func func)
+{
+	Compact();
+	Sort();
+
+	nPairsTested = 0;
+	nOverlaps = 0;
+	for (size_t i = 0; i < vOrder.size(); i++)
+	{
+		Proxy& a = vProxies[vOrder[i]];
+		if ((a.nCategory | a.nCollidesWith) == 0)
+			continue;
+
+		// Everything after a starts to its right, once one starts past its right edge the rest do too
+		for (size_t j = i + 1; j < vOrder.size(); j++)
+		{
+			Proxy& b = vProxies[vOrder[j]];
+			if (b.vMin.x >= a.vMax.x)
+				break;
+			if ((a.nCategory & b.nCollidesWith) == 0 && (b.nCategory & a.nCollidesWith) == 0)
+				continue;
+
+			nPairsTested++;
+			if (a.vMin.y < b.vMax.y && b.vMin.y < a.vMax.y && a.vMin.x < b.vMax.x)
+			{
+				nOverlaps++;
+				func(a.item, b.item);
+			}
+		}
+	}
+}
+
+#endif
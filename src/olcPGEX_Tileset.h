@@ -0,0 +1,140 @@
+/*
+	olcPGEX_Tileset.h
+
+	+-------------------------------------------------------------+
+	|         OneLoneCoder Pixel Game Engine Extension            |
+	|                Tileset - v1.0                               |
+	+-------------------------------------------------------------+
+
+	What is this?
+	~~~~~~~~~~~~~
+	This is an extension to the olcPixelGameEngine v2.0 and above.
+	It describes where every tile id lives: which tilesheet, its
+	source rectangle in pixels and the same rectangle as normalised
+	UVs. The table is filled in once when a sheet is added, after
+	that a lookup is just an index.
+
+	Several tilesheets can be used together, each one owns a range
+	of ids starting at its first id (Tiled calls this the firstgid).
+	The top left tile of a sheet is its first id, the ids then run
+	left to right, top to bottom. Pyxel Edit maps use a single sheet
+	with a first id of 1:
+
+			olc::Tileset tileset;
+			tileset.AddSheet("./sprites/tilesheet.png", 1, { 32, 32 });
+			tileset.AddSheet("./sprites/props.png", 2000, { 32, 32 });
+
+			const olc::Tileset::Region& r = tileset.GetRegion(id);
+			DrawPartialDecal(pos, tileset.GetDecal(r.nSheet), r.vPos, r.vSize);
+
+	Ids that no sheet covers get a region with nSheet == NO_SHEET.
+
+	A region is marked bOpaque when every one of its pixels has full
+	alpha. Whatever is drawn under an opaque tile can't be seen, so
+	a layered map can leave those tiles out.
+
+	Author
+	~~~~~~
+	Frowsty
+
+*/
+
+#ifndef OLC_PGEX_TILESET
+#define OLC_PGEX_TILESET
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace olc
+{
+	class Tileset
+	{
+	public:
+		static constexpr uint16_t NO_SHEET = 0xFFFF;
+
+		struct Region
+		{
+			olc::vi2d vPos = { 0, 0 };		// Source rectangle in pixels
+			olc::vi2d vSize = { 0, 0 };
+			olc::vf2d vUV0 = { 0.0f, 0.0f };	// Same rectangle normalised to the sheet
+			olc::vf2d vUV1 = { 0.0f, 0.0f };
+			uint16_t nSheet = NO_SHEET;
+			bool bOpaque = false;			// No pixel of the tile is even partly transparent
+		};
+
+	public:
+		// Load a tilesheet and give its tiles the ids from nFirstId on, returns the sheet index or -1
+		inline int AddSheet(const std::string& sFile, uint16_t nFirstId, const olc::vi2d& vTileSize);
+		// Same for a sheet that is already in memory, the tileset takes ownership
+		inline int AddSheet(std::unique_ptr<olc::Renderable> pSheet, uint16_t nFirstId, const olc::vi2d& vTileSize);
+		inline void Clear();
+
+		const Region& GetRegion(uint16_t id) const { return id < vRegions.size() ? vRegions[id] : regionNone; }
+		olc::Decal* GetDecal(uint16_t nSheet) const { return nSheet < vSheets.size() ? vSheets[nSheet]->Decal() : nullptr; }
+		olc::Renderable* GetSheet(uint16_t nSheet) const { return nSheet < vSheets.size() ? vSheets[nSheet].get() : nullptr; }
+		size_t SheetCount() const { return vSheets.size(); }
+
+	private:
+		std::vector<std::unique_ptr<olc::Renderable>> vSheets;
+		std::vector<Region> vRegions;
+		Region regionNone;
+	};
+}
+
+int olc::Tileset::AddSheet(const std::string& sFile, uint16_t nFirstId, const olc::vi2d& vTileSize)
+{
+	std::unique_ptr<olc::Renderable> pSheet = std::make_unique<olc::Renderable>();
+	if (pSheet->Load(sFile) != olc::OK)
+		return -1;
+	return AddSheet(std::move(pSheet), nFirstId, vTileSize);
+}
+
+int olc::Tileset::AddSheet(std::unique_ptr<olc::Renderable> pSheet, uint16_t nFirstId, const olc::vi2d& vTileSize)
+{
+	if (!pSheet || pSheet->Sprite() == nullptr || vTileSize.x <= 0 || vTileSize.y <= 0 || vSheets.size() >= NO_SHEET)
+		return -1;
+
+	olc::vi2d vSheetSize = { pSheet->Sprite()->width, pSheet->Sprite()->height };
+	int nColumns = vSheetSize.x / vTileSize.x;
+	int nRows = vSheetSize.y / vTileSize.y;
+	if (nColumns == 0 || nRows == 0)
+		return -1;
+
+	// Ids past the 16-bit range can't be referenced by a map, they're dropped
+	size_t nCount = std::min(size_t(nColumns) * size_t(nRows), size_t(0xFFFF) - nFirstId);
+	if (vRegions.size() < nFirstId + nCount)
+		vRegions.resize(nFirstId + nCount);
+
+	uint16_t nSheet = uint16_t(vSheets.size());
+	olc::vf2d vInvSize = { 1.0f / float(vSheetSize.x), 1.0f / float(vSheetSize.y) };
+	for (size_t i = 0; i < nCount; i++)
+	{
+		Region& r = vRegions[nFirstId + i];
+		r.vPos = { int(i % nColumns) * vTileSize.x, int(i / nColumns) * vTileSize.y };
+		r.vSize = vTileSize;
+		r.vUV0 = olc::vf2d(r.vPos) * vInvSize;
+		r.vUV1 = olc::vf2d(r.vPos + vTileSize) * vInvSize;
+		r.nSheet = nSheet;
+
+		r.bOpaque = true;
+		for (int y = 0; y < vTileSize.y && r.bOpaque; y++)
+		{
+			const olc::Pixel* row = pSheet->Sprite()->GetData() + (r.vPos.y + y) * vSheetSize.x + r.vPos.x;
+			r.bOpaque = std::all_of(row, row + vTileSize.x, [](const olc::Pixel& p) { return p.a == 255; });
+		}
+	}
+
+	vSheets.push_back(std::move(pSheet));
+	return nSheet;
+}
+
+void olc::Tileset::Clear()
+{
+	vSheets.clear();
+	vRegions.clear();
+}
+
+#endif
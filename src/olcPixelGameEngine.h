@@ -261,6 +261,9 @@ int main()
 	#define OLC_GFX_OPENGL10
 #endif
 
+// Defining OLC_PGE_HEADLESS runs the engine without a window or GPU, see olc::headless.
+// The platform code is still compiled in for loading images, but nothing is opened
+
 // O------------------------------------------------------------------------------O
 // | olcPixelGameEngine INTERFACE DECLARATION                                     |
 // O------------------------------------------------------------------------------O
@@ -438,6 +441,7 @@ namespace olc
 
 	public:
 		olc::rcode LoadFromFile(const std::string& sImageFile, olc::ResourcePack *pack = nullptr);
+		olc::rcode LoadFromMemory(const uint8_t* pData, size_t nSize);
 		olc::rcode LoadFromPGESprFile(const std::string& sImageFile, olc::ResourcePack *pack = nullptr);
 		olc::rcode SaveToPGESprFile(const std::string& sImageFile);
 
@@ -458,6 +462,21 @@ namespace olc
 		Pixel* GetData();
 		Pixel *pColData = nullptr;
 		Mode modeSample = Mode::NORMAL;
+
+	public:
+		// Remember which blocks of the sprite SetPixel and MarkDirty touched, so a texture
+		// made from it only needs those uploaded. Writes through GetData() aren't seen
+		void SetDirtyTracking(bool bTrack);
+		bool IsDirtyTracking() const;
+		void MarkDirty(int32_t x, int32_t y, int32_t w, int32_t h);
+		// Merges the dirty blocks into runs of {pos, size} rectangles and forgets them
+		void TakeDirtyRects(std::vector<std::pair<olc::vi2d, olc::vi2d>>& vRects);
+		static constexpr int32_t DIRTY_BLOCK_SHIFT = 4;		// 16x16 pixel blocks
+
+	private:
+		std::vector<uint8_t> vDirty;
+		int32_t nDirtyColumns = 0;
+		bool bAnyDirty = false;
 	};
 
 	// O------------------------------------------------------------------------------O
@@ -467,6 +486,9 @@ namespace olc
 	{
 	public:
 		Decal(olc::Sprite* spr);
+		// A region of another decal's texture (e.g. a texture atlas page) at pos, the size of spr.
+		// It shares that texture, which must outlive it
+		Decal(olc::Decal* page, olc::Sprite* spr, const olc::vi2d& pos);
 		virtual ~Decal();
 		void Update();
 
@@ -474,6 +496,9 @@ namespace olc
 		int32_t id = -1;
 		olc::Sprite* sprite = nullptr;
 		olc::vf2d vUVScale = { 1.0f, 1.0f };
+		olc::vf2d vUVOffset = { 0.0f, 0.0f };	// Where the sprite starts in the texture
+		olc::vf2d vUVSize = { 1.0f, 1.0f };	// And how much of it the sprite covers
+		bool bOwnsTexture = true;
 	};
 
 	// O------------------------------------------------------------------------------O
@@ -485,6 +510,10 @@ namespace olc
 		Renderable() = default;
 		olc::rcode Load(const std::string& sFile, ResourcePack* pack = nullptr);
 		void Create(uint32_t width, uint32_t height);
+		// Take a sprite that was loaded elsewhere (e.g. on another thread) and create its decal
+		void Create(std::unique_ptr<olc::Sprite> sprite);
+		// Draw the sprite through another decal from now on, e.g. a region of a texture atlas
+		void SetDecal(std::unique_ptr<olc::Decal> decal);
 		olc::Decal* Decal() const;
 		olc::Sprite* Sprite() const;
 
@@ -507,6 +536,16 @@ namespace olc
 		olc::Pixel tint[4] = { olc::WHITE, olc::WHITE, olc::WHITE, olc::WHITE };;
 	};
 
+	// One region of a decal for DrawPartialDecalBatch(), the same arguments DrawPartialDecal() takes
+	struct DecalBatchItem
+	{
+		olc::vf2d pos = { 0.0f, 0.0f };
+		olc::vf2d source_pos = { 0.0f, 0.0f };
+		olc::vf2d source_size = { 0.0f, 0.0f };
+		olc::vf2d scale = { 1.0f, 1.0f };
+		olc::Pixel tint = olc::WHITE;
+	};
+
 	struct DecalTriangleInstance
 	{
 		olc::vf2d points[3];
@@ -538,8 +577,11 @@ namespace olc
 		virtual void       PrepareDrawing() = 0;
 		virtual void       DrawLayerQuad(const olc::vf2d& offset, const olc::vf2d& scale, const olc::Pixel tint) = 0;
 		virtual void       DrawDecalQuad(const olc::DecalInstance& decal) = 0;
+		virtual void       FlushDecalQuads() = 0;
 		virtual uint32_t   CreateTexture(const uint32_t width, const uint32_t height) = 0;
 		virtual void       UpdateTexture(uint32_t id, olc::Sprite* spr) = 0;
+		virtual void       UpdateTextureRegions(uint32_t id, olc::Sprite* spr, const std::vector<std::pair<olc::vi2d, olc::vi2d>>& vRects) = 0;
+		virtual void       SetPixelBuffers(uint32_t id, bool bEnable) = 0;
 		virtual uint32_t   DeleteTexture(const uint32_t id) = 0;
 		virtual void       ApplyTexture(uint32_t id) = 0;
 		virtual void       UpdateViewport(const olc::vi2d& pos, const olc::vi2d& size) = 0;
@@ -564,6 +606,35 @@ namespace olc
 	
 	static std::unique_ptr<Renderer> renderer;
 	static std::unique_ptr<Platform> platform;
+
+#if defined(OLC_PGE_HEADLESS)
+	// What the headless renderer was given during one frame
+	struct HeadlessFrame
+	{
+		float fTime = 0.0f;			// Real seconds from reading input to the next frame
+		uint32_t nLayerQuads = 0;
+		uint32_t nDecalQuads = 0;
+		uint32_t nDrawCalls = 0;	// As Renderer_OGL10 would batch them
+		size_t nUploadedBytes = 0;
+	};
+
+	// Set up before Start(), read back after it returns
+	struct HeadlessRun
+	{
+		uint32_t nFrames = 600;				// Stops the engine after this many frames, 0 leaves it to the game
+		float fElapsedTime = 1.0f / 60.0f;	// Given to every OnUserUpdate, 0 uses the real time
+		bool bRasterize = false;			// Draws layers and decals into pFrame like the GPU would
+		int nRasterThreads = 1;				// Rows of the frame are split between this many threads
+		// Called at the start of every frame, before the engine reads the input state. Use
+		// pge->olc_UpdateKeyState() and the other "break in" functions to press things
+		std::function<void(olc::PixelGameEngine* pge, uint32_t nFrame)> funcInput;
+
+		std::vector<HeadlessFrame> vFrames;	// One for every finished frame
+		HeadlessFrame current;
+		std::unique_ptr<olc::Sprite> pFrame;	// The last frame drawn, only when rasterizing
+	};
+	static HeadlessRun headless;
+#endif
 	static std::map<size_t, uint8_t> mapKeys;
 
 	// O------------------------------------------------------------------------------O
@@ -623,6 +694,8 @@ namespace olc
 		uint32_t GetFPS();
 		// Gets last update of elapsed time
 		const float GetElapsedTime() const;
+		// Every frame after this is told the same time passed, 0 goes back to the real clock
+		void SetFixedElapsedTime(float fSeconds);
 		// Gets Actual Window size
 		const olc::vi2d& GetWindowSize() const;
 
@@ -636,6 +709,9 @@ namespace olc
 		void SetLayerScale(uint8_t layer, float x, float y);
 		void SetLayerTint(uint8_t layer, const olc::Pixel& tint);
 		void SetLayerCustomRenderFunction(uint8_t layer, std::function<void()> f);
+		// Upload the layer's changes through pixel buffers where the driver has them, so the copy
+		// into the texture runs while the next frame is drawn. The layer shows up a frame late
+		void SetLayerPixelBuffers(uint8_t layer, bool b);
 
 		std::vector<LayerDesc>& GetLayers();
 		uint32_t CreateLayer();
@@ -695,6 +771,9 @@ namespace olc
 		// Draws a region of a decal, with optional scale and tinting
 		void DrawPartialDecal(const olc::vf2d& pos, olc::Decal* decal, const olc::vf2d& source_pos, const olc::vf2d& source_size, const olc::vf2d& scale = { 1.0f,1.0f }, const olc::Pixel& tint = olc::WHITE);
 		void DrawPartialDecal(const olc::vf2d& pos, const olc::vf2d& size, olc::Decal* decal, const olc::vf2d& source_pos, const olc::vf2d& source_size, const olc::Pixel& tint = olc::WHITE);		
+		// Draws many regions of the same decal at once, the same as calling DrawPartialDecal for each item in order
+		void DrawPartialDecalBatch(olc::Decal* decal, const olc::DecalBatchItem* items, size_t count);
+		void DrawPartialDecalBatch(olc::Decal* decal, const std::vector<olc::DecalBatchItem>& items);
 		// Draws fully user controlled 4 vertices, pos(pixels), uv(pixels), colours
 		void DrawExplicitDecal(olc::Decal* decal, const olc::vf2d *pos, const olc::vf2d *uv, const olc::Pixel *col);
 		// Draws a decal with 4 arbitrary points, warping the texture to look "correct"
@@ -753,12 +832,15 @@ namespace olc
 		bool		bEnableVSYNC          = false;
 		float		fFrameTimer           = 1.0f;
 		float		fLastElapsed          = 0.0f;
+		float		fFixedElapsed         = 0.0f;
 		int			nFrameCount           = 0;
 		Sprite*     fontSprite            = nullptr;
 		Decal*		fontDecal			  = nullptr;
 		Sprite*     pDefaultDrawTarget    = nullptr;
 		std::vector<LayerDesc> vLayers;
 		uint8_t		nTargetLayer          = 0;
+		std::vector<DecalBatchItem> vDecalBatch;	// Reused by DrawStringDecal
+		std::vector<std::pair<olc::vi2d, olc::vi2d>> vDirtyRects;
 		uint32_t	nLastFPS              = 0;
 		std::function<olc::Pixel(const int x, const int y, const olc::Pixel&, const olc::Pixel&)> funcPixelMode;
 		std::chrono::time_point<std::chrono::system_clock> m_tp1, m_tp2;
@@ -780,6 +862,9 @@ namespace olc
 		// components to compile
 		void        olc_ConfigureSystem();
 
+		// The UVs of a whole decal, all of its texture or its region of an atlas
+		void        SetDecalUVs(olc::DecalInstance& di, const olc::Decal* decal);
+
 		// If anything sets this flag to false, the engine
 		// "should" shut down gracefully
 		static std::atomic<bool> bAtomActive;
@@ -983,12 +1068,70 @@ namespace olc
 		if (x >= 0 && x < width && y >= 0 && y < height)
 		{
 			pColData[y*width + x] = p;
+			if (!vDirty.empty())
+			{
+				vDirty[(y >> DIRTY_BLOCK_SHIFT) * nDirtyColumns + (x >> DIRTY_BLOCK_SHIFT)] = 1;
+				bAnyDirty = true;
+			}
 			return true;
 		}
 		else
 			return false;
 	}
 
+	void Sprite::SetDirtyTracking(bool bTrack)
+	{
+		int32_t nBlock = 1 << DIRTY_BLOCK_SHIFT;
+		nDirtyColumns = bTrack ? (width + nBlock - 1) / nBlock : 0;
+		vDirty.assign(bTrack ? size_t(nDirtyColumns) * ((height + nBlock - 1) / nBlock) : 0, 0);
+		bAnyDirty = false;
+	}
+
+	bool Sprite::IsDirtyTracking() const
+	{ return !vDirty.empty(); }
+
+	void Sprite::MarkDirty(int32_t x, int32_t y, int32_t w, int32_t h)
+	{
+		if (vDirty.empty()) return;
+		int32_t x1 = std::min(x + w, width), y1 = std::min(y + h, height);
+		x = std::max(x, 0); y = std::max(y, 0);
+		if (x >= x1 || y >= y1) return;
+		for (int32_t by = y >> DIRTY_BLOCK_SHIFT; by <= (y1 - 1) >> DIRTY_BLOCK_SHIFT; by++)
+			for (int32_t bx = x >> DIRTY_BLOCK_SHIFT; bx <= (x1 - 1) >> DIRTY_BLOCK_SHIFT; bx++)
+				vDirty[by * nDirtyColumns + bx] = 1;
+		bAnyDirty = true;
+	}
+
+	void Sprite::TakeDirtyRects(std::vector<std::pair<olc::vi2d, olc::vi2d>>& vRects)
+	{
+		vRects.clear();
+		if (!bAnyDirty) return;
+
+		// One rectangle per run of dirty blocks in a row of blocks, clipped to the sprite
+		int32_t nBlock = 1 << DIRTY_BLOCK_SHIFT;
+		int32_t nRows = int32_t(vDirty.size()) / nDirtyColumns;
+		for (int32_t by = 0; by < nRows; by++)
+		{
+			uint8_t* row = vDirty.data() + by * nDirtyColumns;
+			for (int32_t bx = 0; bx < nDirtyColumns; )
+			{
+				if (!row[bx]) { bx++; continue; }
+				int32_t first = bx;
+				while (bx < nDirtyColumns && row[bx]) row[bx++] = 0;
+				olc::vi2d pos = { first * nBlock, by * nBlock };
+				olc::vi2d size = { std::min(bx * nBlock, width) - pos.x, std::min(pos.y + nBlock, height) - pos.y };
+
+				// A full width run directly below the last one just makes it taller
+				if (!vRects.empty() && pos.x == 0 && size.x == width && vRects.back().first.x == 0 && vRects.back().second.x == width
+					&& vRects.back().first.y + vRects.back().second.y == pos.y)
+					vRects.back().second.y += size.y;
+				else
+					vRects.push_back({ pos, size });
+			}
+		}
+		bAnyDirty = false;
+	}
+
 	Pixel Sprite::Sample(float x, float y) const
 	{
 		int32_t sx = std::min((int32_t)((x * (float)width)), width - 1);
@@ -1034,9 +1177,20 @@ namespace olc
 		Update();
 	}
 
+	Decal::Decal(olc::Decal* page, olc::Sprite* spr, const olc::vi2d& pos)
+	{
+		id = page->id;
+		sprite = spr;
+		bOwnsTexture = false;
+		vUVScale = page->vUVScale;
+		vUVOffset = olc::vf2d(pos) * vUVScale;
+		vUVSize = olc::vf2d(float(spr->width), float(spr->height)) * vUVScale;
+	}
+
 	void Decal::Update()
 	{
-		if (sprite == nullptr) return;
+		// A region doesn't own the texture, whoever packed it uploads changes
+		if (sprite == nullptr || !bOwnsTexture) return;
 		vUVScale = { 1.0f / float(sprite->width), 1.0f / float(sprite->height) };
 		renderer->ApplyTexture(id);
 		renderer->UpdateTexture(id, sprite);
@@ -1044,7 +1198,7 @@ namespace olc
 
 	Decal::~Decal()
 	{
-		if (id != -1)
+		if (id != -1 && bOwnsTexture)
 		{
 			renderer->DeleteTexture(id);
 			id = -1;
@@ -1057,6 +1211,17 @@ namespace olc
 		pDecal = std::make_unique<olc::Decal>(pSprite.get());
 	}
 
+	void Renderable::Create(std::unique_ptr<olc::Sprite> sprite)
+	{
+		pSprite = std::move(sprite);
+		pDecal = pSprite ? std::make_unique<olc::Decal>(pSprite.get()) : nullptr;
+	}
+
+	void Renderable::SetDecal(std::unique_ptr<olc::Decal> decal)
+	{
+		pDecal = std::move(decal);
+	}
+
 	olc::rcode Renderable::Load(const std::string& sFile, ResourcePack *pack)
 	{
 		pSprite = std::make_unique<olc::Sprite>();
@@ -1300,6 +1465,9 @@ namespace olc
 		{
 			delete layer.pDrawTarget; // Erase existing layer sprites
 			layer.pDrawTarget = new Sprite(vScreenSize.x, vScreenSize.y);
+			renderer->ApplyTexture(layer.nResID);
+			renderer->UpdateTexture(layer.nResID, layer.pDrawTarget);
+			layer.pDrawTarget->SetDirtyTracking(true);
 			layer.bUpdate = true;
 		}
 		SetDrawTarget(nullptr);
@@ -1361,6 +1529,9 @@ namespace olc
 	void PixelGameEngine::EnableLayer(uint8_t layer, bool b)
 	{ if(layer < vLayers.size()) vLayers[layer].bShow = b; }
 
+	void PixelGameEngine::SetLayerPixelBuffers(uint8_t layer, bool b)
+	{ if (layer < vLayers.size()) renderer->SetPixelBuffers(vLayers[layer].nResID, b); }
+
 	void PixelGameEngine::SetLayerOffset(uint8_t layer, const olc::vf2d& offset)
 	{ SetLayerOffset(layer, offset.x, offset.y); }
 
@@ -1388,6 +1559,8 @@ namespace olc
 		ld.pDrawTarget = new olc::Sprite(vScreenSize.x, vScreenSize.y);
 		ld.nResID = renderer->CreateTexture(vScreenSize.x, vScreenSize.y);
 		renderer->UpdateTexture(ld.nResID, ld.pDrawTarget);		
+		// The texture now has its storage, from here on only what's drawn is uploaded
+		ld.pDrawTarget->SetDirtyTracking(true);
 		vLayers.push_back(ld);
 		return uint32_t(vLayers.size()) - 1;
 	}
@@ -1441,6 +1614,9 @@ namespace olc
 	const float PixelGameEngine::GetElapsedTime() const
 	{ return fLastElapsed; }
 
+	void PixelGameEngine::SetFixedElapsedTime(float fSeconds)
+	{ fFixedElapsed = std::max(fSeconds, 0.0f); }
+
 	const olc::vi2d& PixelGameEngine::GetWindowSize() const
 	{ return vWindowSize; }
 
@@ -1672,7 +1848,30 @@ namespace olc
 	{
 		int pixels = GetDrawTargetWidth() * GetDrawTargetHeight();
 		Pixel* m = GetDrawTarget()->GetData();
-		for (int i = 0; i < pixels; i++) m[i] = p;
+		if (!GetDrawTarget()->IsDirtyTracking())
+		{
+			for (int i = 0; i < pixels; i++) m[i] = p;
+			return;
+		}
+
+		// Only pixels that change count as drawn, clearing what was drawn last frame
+		// uploads no more than that
+		int32_t w = GetDrawTargetWidth(), h = GetDrawTargetHeight();
+		int32_t nBlock = 1 << olc::Sprite::DIRTY_BLOCK_SHIFT;
+		for (int32_t y = 0; y < h; y++)
+		{
+			Pixel* row = m + y * w;
+			for (int32_t bx = 0; bx < w; bx += nBlock)
+			{
+				bool bChanged = false;
+				for (int32_t x = bx; x < std::min(bx + nBlock, w); x++)
+				{
+					bChanged |= row[x] != p;
+					row[x] = p;
+				}
+				if (bChanged) GetDrawTarget()->MarkDirty(bx, y, 1, 1);
+			}
+		}
 	}
 
 	void PixelGameEngine::ClearBuffer(Pixel p, bool bDepth)
@@ -1946,13 +2145,63 @@ namespace olc
 		di.pos[2] = { vScreenSpaceDim.x, vScreenSpaceDim.y };
 		di.pos[3] = { vScreenSpaceDim.x, vScreenSpacePos.y };
 
-		olc::vf2d uvtl = source_pos * decal->vUVScale;
+		olc::vf2d uvtl = decal->vUVOffset + source_pos * decal->vUVScale;
 		olc::vf2d uvbr = uvtl + (source_size * decal->vUVScale);
 		di.uv[0] = { uvtl.x, uvtl.y }; di.uv[1] = { uvtl.x, uvbr.y };
 		di.uv[2] = { uvbr.x, uvbr.y }; di.uv[3] = { uvbr.x, uvtl.y };	
 		vLayers[nTargetLayer].vecDecalInstance.push_back(di);
 	}
 
+	void PixelGameEngine::DrawPartialDecalBatch(olc::Decal* decal, const olc::DecalBatchItem* items, size_t count)
+	{
+		std::vector<DecalInstance>& instances = vLayers[nTargetLayer].vecDecalInstance;
+		// Grow at least twice over like push_back would, an exact fit every batch makes filling a layer quadratic
+		if (instances.size() + count > instances.capacity())
+			instances.reserve(std::max(instances.size() + count, instances.capacity() * 2));
+
+		// Kept in locals, the stores below are floats too and would otherwise force them to be reloaded
+		const olc::vf2d vInvSize = vInvScreenSize;
+		const olc::vf2d vUVScale = decal->vUVScale;
+		const olc::vf2d vUVOffset = decal->vUVOffset;
+
+		// Same arithmetic as DrawPartialDecal so the results match exactly
+		DecalInstance di; di.decal = decal;
+		for (size_t i = 0; i < count; i++)
+		{
+			const DecalBatchItem& item = items[i];
+
+			olc::vf2d vScreenSpacePos =
+			{
+				(item.pos.x * vInvSize.x) * 2.0f - 1.0f,
+				((item.pos.y * vInvSize.y) * 2.0f - 1.0f) * -1.0f
+			};
+
+			olc::vf2d vScreenSpaceDim =
+			{
+				vScreenSpacePos.x + (2.0f * item.source_size.x * vInvSize.x) * item.scale.x,
+				vScreenSpacePos.y - (2.0f * item.source_size.y * vInvSize.y) * item.scale.y
+			};
+
+			di.tint[0] = item.tint;
+
+			di.pos[0] = { vScreenSpacePos.x, vScreenSpacePos.y };
+			di.pos[1] = { vScreenSpacePos.x, vScreenSpaceDim.y };
+			di.pos[2] = { vScreenSpaceDim.x, vScreenSpaceDim.y };
+			di.pos[3] = { vScreenSpaceDim.x, vScreenSpacePos.y };
+
+			olc::vf2d uvtl = vUVOffset + item.source_pos * vUVScale;
+			olc::vf2d uvbr = uvtl + (item.source_size * vUVScale);
+			di.uv[0] = { uvtl.x, uvtl.y }; di.uv[1] = { uvtl.x, uvbr.y };
+			di.uv[2] = { uvbr.x, uvbr.y }; di.uv[3] = { uvbr.x, uvtl.y };
+			instances.push_back(di);
+		}
+	}
+
+	void PixelGameEngine::DrawPartialDecalBatch(olc::Decal* decal, const std::vector<olc::DecalBatchItem>& items)
+	{
+		DrawPartialDecalBatch(decal, items.data(), items.size());
+	}
+
 	void PixelGameEngine::DrawPartialDecal(const olc::vf2d& pos, const olc::vf2d& size, olc::Decal* decal, const olc::vf2d& source_pos, const olc::vf2d& source_size, const olc::Pixel& tint)
 	{
 		olc::vf2d vScreenSpacePos =
@@ -1974,7 +2223,7 @@ namespace olc
 		di.pos[2] = { vScreenSpaceDim.x, vScreenSpaceDim.y };
 		di.pos[3] = { vScreenSpaceDim.x, vScreenSpacePos.y };
 
-		olc::vf2d uvtl = source_pos * decal->vUVScale;
+		olc::vf2d uvtl = decal->vUVOffset + source_pos * decal->vUVScale;
 		olc::vf2d uvbr = uvtl + (source_size * decal->vUVScale);
 		di.uv[0] = { uvtl.x, uvtl.y }; di.uv[1] = { uvtl.x, uvbr.y };
 		di.uv[2] = { uvbr.x, uvbr.y }; di.uv[3] = { uvbr.x, uvtl.y };
@@ -2003,9 +2252,18 @@ namespace olc
 		di.pos[1] = { vScreenSpacePos.x, vScreenSpaceDim.y };
 		di.pos[2] = { vScreenSpaceDim.x, vScreenSpaceDim.y };
 		di.pos[3] = { vScreenSpaceDim.x, vScreenSpacePos.y };
+		SetDecalUVs(di, decal);
 		vLayers[nTargetLayer].vecDecalInstance.push_back(di);
 	}
 
+	void PixelGameEngine::SetDecalUVs(olc::DecalInstance& di, const olc::Decal* decal)
+	{
+		olc::vf2d uvtl = decal->vUVOffset;
+		olc::vf2d uvbr = decal->vUVOffset + decal->vUVSize;
+		di.uv[0] = { uvtl.x, uvtl.y }; di.uv[1] = { uvtl.x, uvbr.y };
+		di.uv[2] = { uvbr.x, uvbr.y }; di.uv[3] = { uvbr.x, uvtl.y };
+	}
+
 	void PixelGameEngine::DrawRotatedDecal(const olc::vf2d& pos, olc::Decal* decal, const float fAngle, const olc::vf2d& center, const olc::vf2d& scale, const olc::Pixel& tint)
 	{
 		DecalInstance di;
@@ -2015,6 +2273,7 @@ namespace olc
 		di.pos[1] = (olc::vf2d(0.0f, float(decal->sprite->height)) - center) * scale;
 		di.pos[2] = (olc::vf2d(float(decal->sprite->width), float(decal->sprite->height)) - center) * scale;
 		di.pos[3] = (olc::vf2d(float(decal->sprite->width), 0.0f) - center) * scale;
+		SetDecalUVs(di, decal);
 		float c = cos(fAngle), s = sin(fAngle);
 		for (int i = 0; i < 4; i++)
 		{
@@ -2071,7 +2330,7 @@ namespace olc
 			di.pos[i].y *= -1.0f;
 		}
 
-		olc::vf2d uvtl = source_pos * decal->vUVScale;
+		olc::vf2d uvtl = decal->vUVOffset + source_pos * decal->vUVScale;
 		olc::vf2d uvbr = uvtl + (source_size * decal->vUVScale);
 		di.uv[0] = { uvtl.x, uvtl.y }; di.uv[1] = { uvtl.x, uvbr.y };
 		di.uv[2] = { uvbr.x, uvbr.y }; di.uv[3] = { uvbr.x, uvtl.y };
@@ -2088,7 +2347,7 @@ namespace olc
 		float rd = ((pos[2].x - pos[0].x) * (pos[3].y - pos[1].y) - (pos[3].x - pos[1].x) * (pos[2].y - pos[0].y));
 		if (rd != 0)
 		{
-			olc::vf2d uvtl = source_pos * decal->vUVScale; 
+			olc::vf2d uvtl = decal->vUVOffset + source_pos * decal->vUVScale; 
 			olc::vf2d uvbr = uvtl + (source_size * decal->vUVScale);
 			di.uv[0] = { uvtl.x, uvtl.y }; di.uv[1] = { uvtl.x, uvbr.y };
 			di.uv[2] = { uvbr.x, uvbr.y }; di.uv[3] = { uvbr.x, uvtl.y };
@@ -2115,6 +2374,7 @@ namespace olc
 		DecalInstance di;
 		di.decal = decal;
 		di.tint[0] = tint;
+		SetDecalUVs(di, decal);
 		olc::vf2d center;
 		float rd = ((pos[2].x - pos[0].x) * (pos[3].y - pos[1].y) - (pos[3].x - pos[1].x) * (pos[2].y - pos[0].y));
 		if (rd != 0)
@@ -2149,6 +2409,7 @@ namespace olc
 	void PixelGameEngine::DrawStringDecal(const olc::vf2d& pos, const std::string& sText, const Pixel col, const olc::vf2d& scale)
 	{
 		olc::vf2d spos = { 0.0f, 0.0f };
+		vDecalBatch.clear();
 		for (auto c : sText)
 		{
 			if (c == '\n')
@@ -2159,10 +2420,11 @@ namespace olc
 			{
 				int32_t ox = (c - 32) % 16;
 				int32_t oy = (c - 32) / 16;
-				DrawPartialDecal(pos + spos, fontDecal, { float(ox) * 8.0f, float(oy) * 8.0f }, { 8.0f, 8.0f }, scale, col);
+				vDecalBatch.push_back({ pos + spos, { float(ox) * 8.0f, float(oy) * 8.0f }, { 8.0f, 8.0f }, scale, col });
 				spos.x += 8.0f * scale.x;
 			}
 		}
+		DrawPartialDecalBatch(fontDecal, vDecalBatch);
 	}
 
 	olc::vi2d PixelGameEngine::GetTextSize(const std::string& s)
@@ -2370,7 +2632,7 @@ namespace olc
 		m_tp1 = m_tp2;
 
 		// Our time per frame coefficient
-		float fElapsedTime = elapsedTime.count();       
+		float fElapsedTime = fFixedElapsed > 0.0f ? fFixedElapsed : elapsedTime.count();
 		fLastElapsed = fElapsedTime;		
 
 		// Some platforms will need to check for events
@@ -2430,17 +2692,24 @@ namespace olc
 				if (layer->funcHook == nullptr)
 				{
 					renderer->ApplyTexture(layer->nResID);
-					if (layer->bUpdate)
+					if (layer->pDrawTarget->IsDirtyTracking())
 					{
-						renderer->UpdateTexture(layer->nResID, layer->pDrawTarget);
-						layer->bUpdate = false;
+						// Every frame, what went into a pixel buffer last frame is only copied on the next call
+						vDirtyRects.clear();
+						if (layer->bUpdate)
+							layer->pDrawTarget->TakeDirtyRects(vDirtyRects);
+						renderer->UpdateTextureRegions(layer->nResID, layer->pDrawTarget, vDirtyRects);
 					}
+					else if (layer->bUpdate)
+						renderer->UpdateTexture(layer->nResID, layer->pDrawTarget);
+					layer->bUpdate = false;
 
 					renderer->DrawLayerQuad(layer->vOffset, layer->vScale, layer->tint);
 
 					// Display Decals in order for this layer
 					for (auto& decal : layer->vecDecalInstance)
 						renderer->DrawDecalQuad(decal);
+					renderer->FlushDecalQuads();
 					layer->vecDecalInstance.clear();
 				}
 				else
@@ -2555,6 +2824,24 @@ namespace olc
 	typedef X11::GLXContext glRenderContext_t;
 #endif
 
+	// Pixel buffer objects (OpenGL 2.1 or GL_ARB_pixel_buffer_object) aren't in
+	// every gl.h or opengl32.lib, they're looked up once a context exists
+	#define OLC_GL_PIXEL_UNPACK_BUFFER 0x88EC
+	#define OLC_GL_STREAM_DRAW 0x88E0
+	#define OLC_GL_WRITE_ONLY 0x88B9
+	typedef void(APIENTRY glGenBuffers_t)(GLsizei n, GLuint* buffers);
+	typedef void(APIENTRY glDeleteBuffers_t)(GLsizei n, const GLuint* buffers);
+	typedef void(APIENTRY glBindBuffer_t)(GLenum target, GLuint buffer);
+	typedef void(APIENTRY glBufferData_t)(GLenum target, ptrdiff_t size, const void* data, GLenum usage);
+	typedef void*(APIENTRY glMapBuffer_t)(GLenum target, GLenum access);
+	typedef GLboolean(APIENTRY glUnmapBuffer_t)(GLenum target);
+	static glGenBuffers_t* olc_glGenBuffers = nullptr;
+	static glDeleteBuffers_t* olc_glDeleteBuffers = nullptr;
+	static glBindBuffer_t* olc_glBindBuffer = nullptr;
+	static glBufferData_t* olc_glBufferData = nullptr;
+	static glMapBuffer_t* olc_glMapBuffer = nullptr;
+	static glUnmapBuffer_t* olc_glUnmapBuffer = nullptr;
+
 namespace olc
 {
 	class Renderer_OGL10 : public olc::Renderer
@@ -2563,6 +2850,34 @@ namespace olc
 		glDeviceContext_t glDeviceContext = 0;
 		glRenderContext_t glRenderContext = 0;
 
+		// Decal quads waiting to be drawn with a single glDrawArrays
+		struct BatchVertex
+		{
+			float x, y;
+			float u, v, r, w;
+			float tint[4];	// As floats, glColor4ub rounds the same way
+		};
+		std::vector<BatchVertex> vBatch;
+		uint32_t nBatchTexture = 0;
+
+		// Textures given SetPixelBuffers get a ring of buffers the size of their sprite, allocated
+		// once. A frame's regions are copied into one buffer and only copied into
+		// the texture on the next update, just before the regions of that frame go into the other
+		// buffer, so the driver's copy runs while the CPU draws and fills the next one
+		static constexpr int PIXEL_BUFFERS = 2;
+		struct PixelBufferRing
+		{
+			GLuint buffers[PIXEL_BUFFERS] = {};
+			size_t nSize = 0;
+			int nNext = 0;
+			// Regions waiting in the buffer before nNext
+			std::vector<std::pair<olc::vi2d, olc::vi2d>> vPending;
+			int32_t nPendingWidth = 0;
+			bool bEnabled = true;	// Turned off rings still hand over what they hold
+		};
+		std::map<uint32_t, PixelBufferRing> mapPixelBuffers;
+		int nPixelBufferSupport = -1;	// Not checked yet
+
 	#if defined(__linux__) || defined(__FreeBSD__)
 		X11::Display*				 olc_Display = nullptr;
 		X11::Window*				 olc_Window = nullptr;
@@ -2679,33 +2994,43 @@ namespace olc
 
 		void DrawDecalQuad(const olc::DecalInstance& decal) override
 		{
-			if (decal.decal == nullptr)
+			// Consecutive decals that share a texture are drawn together, a change of
+			// texture draws what was collected so far so the order stays the same
+			uint32_t id = decal.decal == nullptr ? 0 : decal.decal->id;
+			if (id != nBatchTexture)
 			{
-				glBindTexture(GL_TEXTURE_2D, 0);
-				glBegin(GL_QUADS);
-				glColor4ub(decal.tint[0].r, decal.tint[0].g, decal.tint[0].b, decal.tint[0].a);
-				glTexCoord4f(decal.uv[0].x, decal.uv[0].y, 0.0f, decal.w[0]); glVertex2f(decal.pos[0].x, decal.pos[0].y);
-				glColor4ub(decal.tint[1].r, decal.tint[1].g, decal.tint[1].b, decal.tint[1].a);
-				glTexCoord4f(decal.uv[1].x, decal.uv[1].y, 0.0f, decal.w[1]); glVertex2f(decal.pos[1].x, decal.pos[1].y);
-				glColor4ub(decal.tint[2].r, decal.tint[2].g, decal.tint[2].b, decal.tint[2].a);
-				glTexCoord4f(decal.uv[2].x, decal.uv[2].y, 0.0f, decal.w[2]); glVertex2f(decal.pos[2].x, decal.pos[2].y);
-				glColor4ub(decal.tint[3].r, decal.tint[3].g, decal.tint[3].b, decal.tint[3].a);
-				glTexCoord4f(decal.uv[3].x, decal.uv[3].y, 0.0f, decal.w[3]); glVertex2f(decal.pos[3].x, decal.pos[3].y);
-				glEnd();
+				FlushDecalQuads();
+				nBatchTexture = id;
 			}
-			else
+
+			for (int i = 0; i < 4; i++)
 			{
-				glBindTexture(GL_TEXTURE_2D, decal.decal->id);
-				glBegin(GL_QUADS);
-				glColor4ub(decal.tint[0].r, decal.tint[0].g, decal.tint[0].b, decal.tint[0].a);
-				glTexCoord4f(decal.uv[0].x, decal.uv[0].y, 0.0f, decal.w[0]); glVertex2f(decal.pos[0].x, decal.pos[0].y);
-				glTexCoord4f(decal.uv[1].x, decal.uv[1].y, 0.0f, decal.w[1]); glVertex2f(decal.pos[1].x, decal.pos[1].y);
-				glTexCoord4f(decal.uv[2].x, decal.uv[2].y, 0.0f, decal.w[2]); glVertex2f(decal.pos[2].x, decal.pos[2].y);
-				glTexCoord4f(decal.uv[3].x, decal.uv[3].y, 0.0f, decal.w[3]); glVertex2f(decal.pos[3].x, decal.pos[3].y);
-				glEnd();
+				// Textured decals were only ever tinted by their first corner
+				const olc::Pixel& tint = decal.tint[decal.decal == nullptr ? i : 0];
+				vBatch.push_back({ decal.pos[i].x, decal.pos[i].y, decal.uv[i].x, decal.uv[i].y, 0.0f, decal.w[i],
+					{ tint.r / 255.0f, tint.g / 255.0f, tint.b / 255.0f, tint.a / 255.0f } });
 			}
 		}
 
+		void FlushDecalQuads() override
+		{
+			if (vBatch.empty())
+				return;
+
+			glBindTexture(GL_TEXTURE_2D, nBatchTexture);
+			glEnableClientState(GL_VERTEX_ARRAY);
+			glEnableClientState(GL_TEXTURE_COORD_ARRAY);
+			glEnableClientState(GL_COLOR_ARRAY);
+			glVertexPointer(2, GL_FLOAT, sizeof(BatchVertex), &vBatch[0].x);
+			glTexCoordPointer(4, GL_FLOAT, sizeof(BatchVertex), &vBatch[0].u);
+			glColorPointer(4, GL_FLOAT, sizeof(BatchVertex), vBatch[0].tint);
+			glDrawArrays(GL_QUADS, 0, GLsizei(vBatch.size()));
+			glDisableClientState(GL_COLOR_ARRAY);
+			glDisableClientState(GL_TEXTURE_COORD_ARRAY);
+			glDisableClientState(GL_VERTEX_ARRAY);
+			vBatch.clear();
+		}
+
 		uint32_t CreateTexture(const uint32_t width, const uint32_t height) override
 		{
 			uint32_t id = 0;
@@ -2719,15 +3044,167 @@ namespace olc
 
 		uint32_t DeleteTexture(const uint32_t id) override
 		{
+			auto ring = mapPixelBuffers.find(id);
+			if (ring != mapPixelBuffers.end())
+			{
+				olc_glDeleteBuffers(PIXEL_BUFFERS, ring->second.buffers);
+				mapPixelBuffers.erase(ring);
+			}
 			glDeleteTextures(1, &id);			
 			return id;
 		}
 
 		void UpdateTexture(uint32_t id, olc::Sprite* spr) override
 		{
+			// Whatever is still waiting in a pixel buffer is older than this
+			auto ring = mapPixelBuffers.find(id);
+			if (ring != mapPixelBuffers.end())
+				ring->second.vPending.clear();
 			glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, spr->width, spr->height, 0, GL_RGBA, GL_UNSIGNED_BYTE, spr->GetData());
 		}
 
+		void UpdateTextureRegions(uint32_t id, olc::Sprite* spr, const std::vector<std::pair<olc::vi2d, olc::vi2d>>& vRects) override
+		{
+			// The texture has to have been created at the sprite's size, only the regions are copied into it
+			auto ring = mapPixelBuffers.find(id);
+			bool bPending = ring != mapPixelBuffers.end() && !ring->second.vPending.empty();
+			if (vRects.empty() && !bPending) return;
+
+			// Last frame's regions go first, with the buffer bound the pointer is an offset into it
+			if (bPending)
+			{
+				PixelBufferRing& r = ring->second;
+				glPixelStorei(GL_UNPACK_ROW_LENGTH, r.nPendingWidth);
+				olc_glBindBuffer(OLC_GL_PIXEL_UNPACK_BUFFER, r.buffers[(r.nNext + PIXEL_BUFFERS - 1) % PIXEL_BUFFERS]);
+				UploadRegions(r.vPending, r.nPendingWidth, nullptr);
+				olc_glBindBuffer(OLC_GL_PIXEL_UNPACK_BUFFER, 0);
+				r.vPending.clear();
+			}
+			if (vRects.empty())
+			{
+				glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+				return;
+			}
+
+			glPixelStorei(GL_UNPACK_ROW_LENGTH, spr->width);
+			const uint8_t* pSource = reinterpret_cast<const uint8_t*>(spr->GetData());
+			uint8_t* pMapped = MapPixelBuffer(id, spr);
+			if (pMapped != nullptr)
+			{
+				// Same layout as the sprite, so each region sits at the same offset in the buffer
+				for (auto& rect : vRects)
+					for (int32_t y = rect.first.y; y < rect.first.y + rect.second.y; y++)
+					{
+						size_t nOffset = (size_t(y) * spr->width + rect.first.x) * sizeof(olc::Pixel);
+						memcpy(pMapped + nOffset, pSource + nOffset, rect.second.x * sizeof(olc::Pixel));
+					}
+
+				bool bKept = olc_glUnmapBuffer(OLC_GL_PIXEL_UNPACK_BUFFER);
+				olc_glBindBuffer(OLC_GL_PIXEL_UNPACK_BUFFER, 0);
+				if (bKept)
+				{
+					PixelBufferRing& r = mapPixelBuffers[id];
+					r.vPending = vRects;
+					r.nPendingWidth = spr->width;
+				}
+				else
+					UploadRegions(vRects, spr->width, pSource);	// Contents were lost, upload from the sprite instead
+			}
+			else
+				UploadRegions(vRects, spr->width, pSource);
+			glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+		}
+
+		void SetPixelBuffers(uint32_t id, bool bEnable) override
+		{
+			// The buffers themselves are made on the first update
+			if (bEnable)
+				mapPixelBuffers[id].bEnabled = true;
+			else if (mapPixelBuffers.count(id) > 0)
+				mapPixelBuffers[id].bEnabled = false;
+		}
+
+		void UploadRegions(const std::vector<std::pair<olc::vi2d, olc::vi2d>>& vRects, int32_t nRowLength, const uint8_t* pSource)
+		{
+			for (auto& rect : vRects)
+			{
+				size_t nOffset = (size_t(rect.first.y) * nRowLength + rect.first.x) * sizeof(olc::Pixel);
+				glTexSubImage2D(GL_TEXTURE_2D, 0, rect.first.x, rect.first.y, rect.second.x, rect.second.y, GL_RGBA, GL_UNSIGNED_BYTE, pSource + nOffset);
+			}
+		}
+
+		// Binds the next buffer of the texture's ring and maps it, nullptr when there are no pixel buffers
+		uint8_t* MapPixelBuffer(uint32_t id, olc::Sprite* spr)
+		{
+			auto it = mapPixelBuffers.find(id);
+			if (it == mapPixelBuffers.end() || !it->second.bEnabled || !HasPixelBuffers())
+				return nullptr;
+
+			PixelBufferRing& ring = it->second;
+			size_t nSize = size_t(spr->width) * size_t(spr->height) * sizeof(olc::Pixel);
+			if (ring.buffers[0] == 0)
+				olc_glGenBuffers(PIXEL_BUFFERS, ring.buffers);
+			if (ring.nSize != nSize)
+			{
+				for (GLuint buffer : ring.buffers)
+				{
+					olc_glBindBuffer(OLC_GL_PIXEL_UNPACK_BUFFER, buffer);
+					olc_glBufferData(OLC_GL_PIXEL_UNPACK_BUFFER, ptrdiff_t(nSize), nullptr, OLC_GL_STREAM_DRAW);
+				}
+				ring.nSize = nSize;
+			}
+
+			olc_glBindBuffer(OLC_GL_PIXEL_UNPACK_BUFFER, ring.buffers[ring.nNext]);
+			ring.nNext = (ring.nNext + 1) % PIXEL_BUFFERS;
+			uint8_t* pMapped = static_cast<uint8_t*>(olc_glMapBuffer(OLC_GL_PIXEL_UNPACK_BUFFER, OLC_GL_WRITE_ONLY));
+			if (pMapped == nullptr)
+				olc_glBindBuffer(OLC_GL_PIXEL_UNPACK_BUFFER, 0);
+			return pMapped;
+		}
+
+		bool HasPixelBuffers()
+		{
+			if (nPixelBufferSupport >= 0)
+				return nPixelBufferSupport == 1;
+
+			// Core since OpenGL 2.1, before that an extension
+			const char* sVersion = reinterpret_cast<const char*>(glGetString(GL_VERSION));
+			const char* sExtensions = reinterpret_cast<const char*>(glGetString(GL_EXTENSIONS));
+			int nMajor = 0, nMinor = 0;
+			if (sVersion != nullptr)
+				sscanf(sVersion, "%d.%d", &nMajor, &nMinor);
+			bool bSupported = nMajor > 2 || (nMajor == 2 && nMinor >= 1) ||
+				(sExtensions != nullptr && strstr(sExtensions, "GL_ARB_pixel_buffer_object") != nullptr);
+
+			if (bSupported)
+			{
+				olc_glGenBuffers = (glGenBuffers_t*)GetGLProc("glGenBuffers");
+				olc_glDeleteBuffers = (glDeleteBuffers_t*)GetGLProc("glDeleteBuffers");
+				olc_glBindBuffer = (glBindBuffer_t*)GetGLProc("glBindBuffer");
+				olc_glBufferData = (glBufferData_t*)GetGLProc("glBufferData");
+				olc_glMapBuffer = (glMapBuffer_t*)GetGLProc("glMapBuffer");
+				olc_glUnmapBuffer = (glUnmapBuffer_t*)GetGLProc("glUnmapBuffer");
+				bSupported = olc_glGenBuffers && olc_glDeleteBuffers && olc_glBindBuffer &&
+					olc_glBufferData && olc_glMapBuffer && olc_glUnmapBuffer;
+			}
+			nPixelBufferSupport = bSupported ? 1 : 0;
+			return bSupported;
+		}
+
+		static void* GetGLProc(const char* sName)
+		{
+		#if defined(_WIN32)
+			return (void*)wglGetProcAddress(sName);
+		#endif
+
+		#if defined(__linux__) || defined(__FreeBSD__)
+			return (void*)X11::glXGetProcAddress((const unsigned char*)sName);
+		#endif
+
+			// Nowhere to look the functions up, HasPixelBuffers reports no support
+			return nullptr;
+		}
+
 		void ApplyTexture(uint32_t id) override
 		{
 			glBindTexture(GL_TEXTURE_2D, id);
@@ -3009,6 +3486,30 @@ namespace olc
 		delete bmp;
 		return olc::OK;
 	}
+
+	olc::rcode Sprite::LoadFromMemory(const uint8_t* pData, size_t nSize)
+	{
+		IStream* stream = SHCreateMemStream((const BYTE*)pData, UINT(nSize));
+		if (stream == nullptr) return olc::FAIL;
+		Gdiplus::Bitmap* bmp = Gdiplus::Bitmap::FromStream(stream);
+		stream->Release();
+
+		if (bmp == nullptr) return olc::FAIL;
+		if (bmp->GetLastStatus() != Gdiplus::Ok) { delete bmp; return olc::FAIL; }
+		width = bmp->GetWidth();
+		height = bmp->GetHeight();
+		pColData = new Pixel[width * height];
+
+		for (int y = 0; y < height; y++)
+			for (int x = 0; x < width; x++)
+			{
+				Gdiplus::Color c;
+				bmp->GetPixel(x, y, &c);
+				SetPixel(x, y, olc::Pixel(c.GetRed(), c.GetGreen(), c.GetBlue(), c.GetAlpha()));
+			}
+		delete bmp;
+		return olc::OK;
+	}
 }
 #endif
 // O------------------------------------------------------------------------------O
@@ -3245,9 +3746,10 @@ namespace olc
 		((std::istream*)a)->read((char*)data, length);
 	}
 
-	olc::rcode Sprite::LoadFromFile(const std::string& sImageFile, olc::ResourcePack* pack)
+	// Decodes a png into the sprite, reading from the FILE when one is given,
+	// otherwise from the stream
+	static olc::rcode pngLoadSprite(olc::Sprite* spr, FILE* f, std::istream* is)
 	{
-		UNUSED(pack);
 		////////////////////////////////////////////////////////////////////////////
 		// Use libpng, Thanks to Guillaume Cottenceau
 		// https://gist.github.com/niw/5963798
@@ -3264,8 +3766,8 @@ namespace olc
 			png_byte color_type;
 			png_byte bit_depth;
 			png_bytep* row_pointers;
-			width = png_get_image_width(png, info);
-			height = png_get_image_height(png, info);
+			spr->width = png_get_image_width(png, info);
+			spr->height = png_get_image_height(png, info);
 			color_type = png_get_color_type(png, info);
 			bit_depth = png_get_bit_depth(png, info);
 			if (bit_depth == 16) png_set_strip_16(png);
@@ -3280,26 +3782,26 @@ namespace olc
 				color_type == PNG_COLOR_TYPE_GRAY_ALPHA)
 				png_set_gray_to_rgb(png);
 			png_read_update_info(png, info);
-			row_pointers = (png_bytep*)malloc(sizeof(png_bytep) * height);
-			for (int y = 0; y < height; y++) {
+			row_pointers = (png_bytep*)malloc(sizeof(png_bytep) * spr->height);
+			for (int y = 0; y < spr->height; y++) {
 				row_pointers[y] = (png_byte*)malloc(png_get_rowbytes(png, info));
 			}
 			png_read_image(png, row_pointers);
 			////////////////////////////////////////////////////////////////////////////
 			// Create sprite array
-			pColData = new Pixel[width * height];
+			spr->pColData = new Pixel[spr->width * spr->height];
 			// Iterate through image rows, converting into sprite format
-			for (int y = 0; y < height; y++)
+			for (int y = 0; y < spr->height; y++)
 			{
 				png_bytep row = row_pointers[y];
-				for (int x = 0; x < width; x++)
+				for (int x = 0; x < spr->width; x++)
 				{
 					png_bytep px = &(row[x * 4]);
-					SetPixel(x, y, Pixel(px[0], px[1], px[2], px[3]));
+					spr->SetPixel(x, y, Pixel(px[0], px[1], px[2], px[3]));
 				}
 			}
 
-			for (int y = 0; y < height; y++) // Thanks maksym33
+			for (int y = 0; y < spr->height; y++) // Thanks maksym33
 				free(row_pointers[y]);
 			free(row_pointers);
 			png_destroy_read_struct(&png, &info, nullptr);			
@@ -3313,29 +3815,49 @@ namespace olc
 
 		if (setjmp(png_jmpbuf(png))) goto fail_load;
 
+		if (f != nullptr)
+			png_init_io(png, f);
+		else
+			png_set_read_fn(png, (png_voidp)is, pngReadStream);
+		loadPNG();
+
+		return olc::OK;
+
+	fail_load:
+		spr->width = 0;
+		spr->height = 0;
+		spr->pColData = nullptr;
+		return olc::FAIL;
+	}
+
+	olc::rcode Sprite::LoadFromFile(const std::string& sImageFile, olc::ResourcePack* pack)
+	{
 		if (pack == nullptr)
 		{
 			FILE* f = fopen(sImageFile.c_str(), "rb");
 			if (!f) return olc::NO_FILE;
-			png_init_io(png, f);
-			loadPNG();
+			olc::rcode r = pngLoadSprite(this, f, nullptr);
 			fclose(f);
+			return r;
 		}
 		else
 		{
 			ResourceBuffer rb = pack->GetFileBuffer(sImageFile);
 			std::istream is(&rb);
-			png_set_read_fn(png, (png_voidp)&is, pngReadStream);
-			loadPNG();
+			return pngLoadSprite(this, nullptr, &is);
 		}
+	}
 
-		return olc::OK;
+	olc::rcode Sprite::LoadFromMemory(const uint8_t* pData, size_t nSize)
+	{
+		struct MemoryBuffer : public std::streambuf
+		{
+			MemoryBuffer(const uint8_t* p, size_t n) { char* c = (char*)p; setg(c, c, c + n); }
+		};
 
-	fail_load:
-		width = 0;
-		height = 0;
-		pColData = nullptr;
-		return olc::FAIL;
+		MemoryBuffer mb(pData, nSize);
+		std::istream is(&mb);
+		return pngLoadSprite(this, nullptr, &is);
 	}
 }
 #endif
@@ -3343,10 +3865,797 @@ namespace olc
 // | END PLATFORM: LINUX                                                          |
 // O------------------------------------------------------------------------------O
 
+// O------------------------------------------------------------------------------O
+// | START PLATFORM & RENDERER: HEADLESS                                          |
+// O------------------------------------------------------------------------------O
+#if defined(OLC_PGE_HEADLESS)
+#if defined(__x86_64__) || defined(_M_X64)
+	#include <immintrin.h>
+	#if defined(_MSC_VER)
+		#include <intrin.h>
+	#endif
+#endif
+
+// The AVX2 path is chosen at runtime, only it is compiled for AVX2
+#if defined(__GNUC__)
+	#define OLC_TARGET_AVX2 __attribute__((target("avx2")))
+	#define OLC_FLATTEN __attribute__((flatten))
+#else
+	#define OLC_TARGET_AVX2
+	#define OLC_FLATTEN
+#endif
+
+namespace olc
+{
+	// Draws DecalInstance quads into a sprite on the CPU, the way Renderer_OGL10 has the
+	// GPU do it: two triangles per quad, texture coordinates divided by w per pixel,
+	// textures repeating, tinted and alpha blended. Quads are queued and drawn on Flush(),
+	// split into bands of rows when there's more than one thread. The SSE2 and AVX2 paths
+	// do the same float operations in the same order as the scalar one, so all three
+	// give the same pixels.
+	class SoftwareRasterizer
+	{
+	public:
+		struct Texture
+		{
+			int32_t width = 0;
+			int32_t height = 0;
+			std::vector<olc::Pixel> vPixels;
+		};
+		enum class Sampling { NEAREST, BILINEAR };
+		enum class Path { SCALAR, SSE2, AVX2 };
+
+	public:
+		SoftwareRasterizer() : path(BestPath()) { }
+
+		// Flushes whatever was queued for the previous target
+		void SetTarget(olc::Sprite* target) { Flush(); pTarget = target; }
+		olc::Sprite* GetTarget() const { return pTarget; }
+		void SetThreads(int n) { nThreads = std::max(1, n); }
+		// Pick a slower path to compare against, paths the CPU doesn't have are ignored
+		void SetPath(Path p) { if (p <= BestPath()) path = p; }
+		Path GetPath() const { return path; }
+
+		// The texture has to stay as it is until the next Flush(), see Uses()
+		void DrawQuad(const olc::DecalInstance& di, const Texture* tex, bool bVertexTint, Sampling sampling = Sampling::NEAREST);
+		void Flush();
+		// True when a queued quad reads from the texture, flush before changing it
+		bool Uses(const Texture* tex) const { return std::find(vTextures.begin(), vTextures.end(), tex) != vTextures.end(); }
+
+		static Path BestPath();
+
+	public:
+		// One triangle ready for drawing: edge functions A*(x - ox) + B*(y - oy), positive inside,
+		// and every attribute as a plane dx*x + (dy*y + c), all at pixel centres
+		struct Edge { float A, B, ox, oy; bool bOwns; };
+		struct Plane { float dx, dy, c; };
+		struct Triangle
+		{
+			Edge edges[3];
+			Plane u, v, w, tint[4];
+			bool bPerspective, bConstantTint;
+			const Texture* tex;
+			Sampling sampling;
+			int32_t x0, y0, x1, y1;
+		};
+
+	private:
+		struct Vertex { olc::vf2d pos; float u, v, w; float tint[4]; };
+		void AddTriangle(const Vertex& a, Vertex b, Vertex c, const Texture* tex, Sampling sampling);
+		void DrawRows(int32_t y0, int32_t y1);
+
+	private:
+		olc::Sprite* pTarget = nullptr;
+		int nThreads = 1;
+		Path path;
+		std::vector<Triangle> vTriangles;
+		std::vector<const Texture*> vTextures;
+	};
+
+	namespace raster
+	{
+		// Every lane type has the same operations, ShadeSpan is written once against them
+		struct LanesScalar
+		{
+			static constexpr int N = 1;
+			typedef float F;
+			typedef int32_t I;
+			static inline F Set(float f) { return f; }
+			static inline I SetI(int32_t i) { return i; }
+			static inline F Lanes() { return 0.0f; }
+			static inline F Add(F a, F b) { return a + b; }
+			static inline F Sub(F a, F b) { return a - b; }
+			static inline F Mul(F a, F b) { return a * b; }
+			static inline F Div(F a, F b) { return a / b; }
+			static inline F Floor(F a) { return std::floor(a); }
+			// b when either is NaN, like minps and maxps
+			static inline F Min(F a, F b) { return a < b ? a : b; }
+			static inline F Max(F a, F b) { return a > b ? a : b; }
+			static inline I ToInt(F a) { return int32_t(a); }
+			static inline F ToFloat(I a) { return float(a); }
+			static inline I Gt(F a, F b) { return a > b ? -1 : 0; }
+			static inline I Ge(F a, F b) { return a >= b ? -1 : 0; }
+			static inline I Lt(F a, F b) { return a < b ? -1 : 0; }
+			static inline I Eq(F a, F b) { return a == b ? -1 : 0; }
+			static inline I And(I a, I b) { return a & b; }
+			static inline I Or(I a, I b) { return a | b; }
+			static inline bool Any(I m) { return m != 0; }
+			static inline I Select(I m, I a, I b) { return (a & m) | (b & ~m); }
+			static inline F SelectF(I m, F a, F b) { return m ? a : b; }
+			static inline I Shr(I a, int n) { return int32_t(uint32_t(a) >> n); }
+			static inline I Shl(I a, int n) { return int32_t(uint32_t(a) << n); }
+			static inline I Load(const olc::Pixel* p) { return int32_t(p->n); }
+			static inline void Store(olc::Pixel* p, I a) { p->n = uint32_t(a); }
+			static inline I Gather(const olc::Pixel* p, I idx) { return int32_t(p[idx].n); }
+		};
+
+	#if defined(__x86_64__) || defined(_M_X64)
+		struct LanesSSE2
+		{
+			static constexpr int N = 4;
+			typedef __m128 F;
+			typedef __m128i I;
+			static inline F Set(float f) { return _mm_set1_ps(f); }
+			static inline I SetI(int32_t i) { return _mm_set1_epi32(i); }
+			static inline F Lanes() { return _mm_setr_ps(0.0f, 1.0f, 2.0f, 3.0f); }
+			static inline F Add(F a, F b) { return _mm_add_ps(a, b); }
+			static inline F Sub(F a, F b) { return _mm_sub_ps(a, b); }
+			static inline F Mul(F a, F b) { return _mm_mul_ps(a, b); }
+			static inline F Div(F a, F b) { return _mm_div_ps(a, b); }
+			static inline F Floor(F a)
+			{
+				// No round instruction before SSE4.1, truncate and step down where that went up
+				F t = _mm_cvtepi32_ps(_mm_cvttps_epi32(a));
+				return _mm_sub_ps(t, _mm_and_ps(_mm_cmpgt_ps(t, a), _mm_set1_ps(1.0f)));
+			}
+			static inline F Min(F a, F b) { return _mm_min_ps(a, b); }
+			static inline F Max(F a, F b) { return _mm_max_ps(a, b); }
+			static inline I ToInt(F a) { return _mm_cvttps_epi32(a); }
+			static inline F ToFloat(I a) { return _mm_cvtepi32_ps(a); }
+			static inline I Gt(F a, F b) { return _mm_castps_si128(_mm_cmpgt_ps(a, b)); }
+			static inline I Ge(F a, F b) { return _mm_castps_si128(_mm_cmpge_ps(a, b)); }
+			static inline I Lt(F a, F b) { return _mm_castps_si128(_mm_cmplt_ps(a, b)); }
+			static inline I Eq(F a, F b) { return _mm_castps_si128(_mm_cmpeq_ps(a, b)); }
+			static inline I And(I a, I b) { return _mm_and_si128(a, b); }
+			static inline I Or(I a, I b) { return _mm_or_si128(a, b); }
+			static inline bool Any(I m) { return _mm_movemask_epi8(m) != 0; }
+			static inline I Select(I m, I a, I b) { return _mm_or_si128(_mm_and_si128(m, a), _mm_andnot_si128(m, b)); }
+			static inline F SelectF(I m, F a, F b) { F mf = _mm_castsi128_ps(m); return _mm_or_ps(_mm_and_ps(mf, a), _mm_andnot_ps(mf, b)); }
+			static inline I Shr(I a, int n) { return _mm_srli_epi32(a, n); }
+			static inline I Shl(I a, int n) { return _mm_slli_epi32(a, n); }
+			static inline I Load(const olc::Pixel* p) { return _mm_loadu_si128((const __m128i*)p); }
+			static inline void Store(olc::Pixel* p, I a) { _mm_storeu_si128((__m128i*)p, a); }
+			static inline I Gather(const olc::Pixel* p, I idx)
+			{
+				alignas(16) int32_t i[4];
+				_mm_store_si128((__m128i*)i, idx);
+				return _mm_setr_epi32(int32_t(p[i[0]].n), int32_t(p[i[1]].n), int32_t(p[i[2]].n), int32_t(p[i[3]].n));
+			}
+		};
+
+		// ShadeSpan and the templates around it aren't compiled for AVX2, they are only inlined into
+		// ShadeSpanAVX2. Bare __m256 arguments would be passed differently by them and the lane
+		// operations whenever they aren't inlined, as at -O0. A user provided copy constructor makes
+		// the lanes non-trivial, so the C++ ABI passes them by reference whatever the target
+		struct LanesAVX2
+		{
+			static constexpr int N = 8;
+			struct F
+			{
+				__m256 v;
+				F() = default;
+				OLC_TARGET_AVX2 F(__m256 a) : v(a) { }
+				OLC_TARGET_AVX2 F(const F& f) : v(f.v) { }
+				F& operator=(const F& f) = default;
+			};
+			struct I
+			{
+				__m256i v;
+				I() = default;
+				OLC_TARGET_AVX2 I(__m256i a) : v(a) { }
+				OLC_TARGET_AVX2 I(const I& i) : v(i.v) { }
+				I& operator=(const I& i) = default;
+			};
+			OLC_TARGET_AVX2 static inline F Set(float f) { return { _mm256_set1_ps(f) }; }
+			OLC_TARGET_AVX2 static inline I SetI(int32_t i) { return { _mm256_set1_epi32(i) }; }
+			OLC_TARGET_AVX2 static inline F Lanes() { return { _mm256_setr_ps(0.0f, 1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f) }; }
+			OLC_TARGET_AVX2 static inline F Add(F a, F b) { return { _mm256_add_ps(a.v, b.v) }; }
+			OLC_TARGET_AVX2 static inline F Sub(F a, F b) { return { _mm256_sub_ps(a.v, b.v) }; }
+			OLC_TARGET_AVX2 static inline F Mul(F a, F b) { return { _mm256_mul_ps(a.v, b.v) }; }
+			OLC_TARGET_AVX2 static inline F Div(F a, F b) { return { _mm256_div_ps(a.v, b.v) }; }
+			OLC_TARGET_AVX2 static inline F Floor(F a) { return { _mm256_floor_ps(a.v) }; }
+			OLC_TARGET_AVX2 static inline F Min(F a, F b) { return { _mm256_min_ps(a.v, b.v) }; }
+			OLC_TARGET_AVX2 static inline F Max(F a, F b) { return { _mm256_max_ps(a.v, b.v) }; }
+			OLC_TARGET_AVX2 static inline I ToInt(F a) { return { _mm256_cvttps_epi32(a.v) }; }
+			OLC_TARGET_AVX2 static inline F ToFloat(I a) { return { _mm256_cvtepi32_ps(a.v) }; }
+			OLC_TARGET_AVX2 static inline I Gt(F a, F b) { return { _mm256_castps_si256(_mm256_cmp_ps(a.v, b.v, _CMP_GT_OQ)) }; }
+			OLC_TARGET_AVX2 static inline I Ge(F a, F b) { return { _mm256_castps_si256(_mm256_cmp_ps(a.v, b.v, _CMP_GE_OQ)) }; }
+			OLC_TARGET_AVX2 static inline I Lt(F a, F b) { return { _mm256_castps_si256(_mm256_cmp_ps(a.v, b.v, _CMP_LT_OQ)) }; }
+			OLC_TARGET_AVX2 static inline I Eq(F a, F b) { return { _mm256_castps_si256(_mm256_cmp_ps(a.v, b.v, _CMP_EQ_OQ)) }; }
+			OLC_TARGET_AVX2 static inline I And(I a, I b) { return { _mm256_and_si256(a.v, b.v) }; }
+			OLC_TARGET_AVX2 static inline I Or(I a, I b) { return { _mm256_or_si256(a.v, b.v) }; }
+			OLC_TARGET_AVX2 static inline bool Any(I m) { return !_mm256_testz_si256(m.v, m.v); }
+			OLC_TARGET_AVX2 static inline I Select(I m, I a, I b) { return { _mm256_blendv_epi8(b.v, a.v, m.v) }; }
+			OLC_TARGET_AVX2 static inline F SelectF(I m, F a, F b) { return { _mm256_blendv_ps(b.v, a.v, _mm256_castsi256_ps(m.v)) }; }
+			OLC_TARGET_AVX2 static inline I Shr(I a, int n) { return { _mm256_srli_epi32(a.v, n) }; }
+			OLC_TARGET_AVX2 static inline I Shl(I a, int n) { return { _mm256_slli_epi32(a.v, n) }; }
+			OLC_TARGET_AVX2 static inline I Load(const olc::Pixel* p) { return { _mm256_loadu_si256((const __m256i*)p) }; }
+			OLC_TARGET_AVX2 static inline void Store(olc::Pixel* p, I a) { _mm256_storeu_si256((__m256i*)p, a.v); }
+			OLC_TARGET_AVX2 static inline I Gather(const olc::Pixel* p, I idx) { return { _mm256_i32gather_epi32((const int*)p, idx.v, 4) }; }
+		};
+	#endif
+
+		template<class L>
+		static inline typename L::F PlaneAt(const SoftwareRasterizer::Plane& p, typename L::F px, float py)
+		{ return L::Add(L::Mul(L::Set(p.dx), px), L::Set(p.dy * py + p.c)); }
+
+		// Texel coordinates outside the texture wrap around, the same as GL_REPEAT. Where w is near
+		// zero they can be too large to wrap or NaN, those are clamped so they still land on a texel
+		template<class L>
+		static inline typename L::F Wrap(typename L::F t, float fSize, float fInvSize)
+		{
+			typename L::F size = L::Set(fSize);
+			t = L::Sub(t, L::Mul(L::Floor(L::Mul(t, L::Set(fInvSize))), size));
+			t = L::SelectF(L::Ge(t, size), L::Sub(t, size), t);
+			t = L::SelectF(L::Lt(t, L::Set(0.0f)), L::Add(t, size), t);
+			return L::Max(L::Min(t, L::Set(fSize - 1.0f)), L::Set(0.0f));
+		}
+
+		// Lanes outside the triangle read the first texel, whatever their coordinates came to
+		template<class L>
+		static inline typename L::I Texel(const SoftwareRasterizer::Texture& tex, typename L::I mask, typename L::F index)
+		{ return L::Gather(tex.vPixels.data(), L::Select(mask, L::ToInt(index), L::SetI(0))); }
+
+		template<class L>
+		static inline typename L::F Channel(typename L::I p, int nShift)
+		{ return L::ToFloat(L::And(L::Shr(p, nShift), L::SetI(0xFF))); }
+
+		template<class L>
+		static inline typename L::F Bilinear(typename L::I t00, typename L::I t10, typename L::I t01, typename L::I t11,
+			typename L::F ax, typename L::F ay, int nShift)
+		{
+			typename L::F c00 = Channel<L>(t00, nShift), c10 = Channel<L>(t10, nShift);
+			typename L::F c01 = Channel<L>(t01, nShift), c11 = Channel<L>(t11, nShift);
+			typename L::F top = L::Add(c00, L::Mul(L::Sub(c10, c00), ax));
+			typename L::F bottom = L::Add(c01, L::Mul(L::Sub(c11, c01), ax));
+			return L::Add(top, L::Mul(L::Sub(bottom, top), ay));
+		}
+
+		// One channel of src over dst, rounded to the nearest whole value
+		template<class L>
+		static inline typename L::I Blend(typename L::F src, typename L::F a, typename L::F keep, typename L::I dst, int nShift)
+		{ return L::ToInt(L::Add(L::Add(L::Mul(src, a), L::Mul(Channel<L>(dst, nShift), keep)), L::Set(0.5f))); }
+
+		// Shades pixels x0 to x1 of a row of the target
+		template<class L>
+		static inline void ShadeSpan(const SoftwareRasterizer::Triangle& t, int32_t y, int32_t x0, int32_t x1, olc::Pixel* row)
+		{
+			typedef typename L::F F;
+			typedef typename L::I I;
+			const float py = float(y) + 0.5f;
+			const F zero = L::Set(0.0f), one = L::Set(1.0f), half = L::Set(0.5f), full = L::Set(255.0f);
+
+			float fEdgeRow[3];
+			for (int i = 0; i < 3; i++)
+				fEdgeRow[i] = t.edges[i].B * (py - t.edges[i].oy);
+
+			olc::Pixel tail[L::N];
+			for (int32_t x = x0; x <= x1; x += L::N)
+			{
+				const F px = L::Add(L::Set(float(x) + 0.5f), L::Lanes());
+
+				// Inside all three edges, pixels on an edge belong to the triangle that owns it
+				I mask = L::Lt(px, L::Set(float(x1) + 1.0f));
+				for (int i = 0; i < 3; i++)
+				{
+					const SoftwareRasterizer::Edge& e = t.edges[i];
+					F fe = L::Add(L::Mul(L::Set(e.A), L::Sub(px, L::Set(e.ox))), L::Set(fEdgeRow[i]));
+					I inside = e.bOwns ? L::Ge(fe, zero) : L::Gt(fe, zero);
+					mask = L::And(mask, inside);
+				}
+				if (!L::Any(mask))
+					continue;
+
+				F r, g, b, a;
+				if (t.bConstantTint)
+				{
+					r = L::Set(t.tint[0].c); g = L::Set(t.tint[1].c); b = L::Set(t.tint[2].c); a = L::Set(t.tint[3].c);
+				}
+				else
+				{
+					r = PlaneAt<L>(t.tint[0], px, py); g = PlaneAt<L>(t.tint[1], px, py);
+					b = PlaneAt<L>(t.tint[2], px, py); a = PlaneAt<L>(t.tint[3], px, py);
+				}
+
+				if (t.tex != nullptr)
+				{
+					const SoftwareRasterizer::Texture& tex = *t.tex;
+					const float fW = float(tex.width), fH = float(tex.height);
+					const float fInvW = 1.0f / fW, fInvH = 1.0f / fH;
+					F s = PlaneAt<L>(t.u, px, py), tt = PlaneAt<L>(t.v, px, py);
+					if (t.bPerspective)
+					{
+						F q = PlaneAt<L>(t.w, px, py);
+						s = L::Div(s, q);
+						tt = L::Div(tt, q);
+					}
+
+					F cr, cg, cb, ca;
+					if (t.sampling == SoftwareRasterizer::Sampling::NEAREST)
+					{
+						F tx = Wrap<L>(L::Floor(L::Mul(s, L::Set(fW))), fW, fInvW);
+						F ty = Wrap<L>(L::Floor(L::Mul(tt, L::Set(fH))), fH, fInvH);
+						I texel = Texel<L>(tex, mask, L::Add(L::Mul(ty, L::Set(fW)), tx));
+						cr = Channel<L>(texel, 0); cg = Channel<L>(texel, 8); cb = Channel<L>(texel, 16); ca = Channel<L>(texel, 24);
+					}
+					else
+					{
+						// Between the four nearest texel centres
+						F sx = L::Sub(L::Mul(s, L::Set(fW)), half), sy = L::Sub(L::Mul(tt, L::Set(fH)), half);
+						F fx = L::Floor(sx), fy = L::Floor(sy);
+						F ax = L::Sub(sx, fx), ay = L::Sub(sy, fy);
+						F tx0 = Wrap<L>(fx, fW, fInvW), tx1 = Wrap<L>(L::Add(fx, one), fW, fInvW);
+						F ty0 = L::Mul(Wrap<L>(fy, fH, fInvH), L::Set(fW)), ty1 = L::Mul(Wrap<L>(L::Add(fy, one), fH, fInvH), L::Set(fW));
+						I t00 = Texel<L>(tex, mask, L::Add(ty0, tx0));
+						I t10 = Texel<L>(tex, mask, L::Add(ty0, tx1));
+						I t01 = Texel<L>(tex, mask, L::Add(ty1, tx0));
+						I t11 = Texel<L>(tex, mask, L::Add(ty1, tx1));
+						cr = Bilinear<L>(t00, t10, t01, t11, ax, ay, 0);
+						cg = Bilinear<L>(t00, t10, t01, t11, ax, ay, 8);
+						cb = Bilinear<L>(t00, t10, t01, t11, ax, ay, 16);
+						ca = Bilinear<L>(t00, t10, t01, t11, ax, ay, 24);
+					}
+					r = L::Mul(r, cr); g = L::Mul(g, cg); b = L::Mul(b, cb);
+					a = L::Mul(a, L::Mul(ca, L::Set(1.0f / 255.0f)));
+				}
+				else
+				{
+					r = L::Mul(r, full); g = L::Mul(g, full); b = L::Mul(b, full);
+				}
+
+				// Nothing shows through where it's fully transparent
+				mask = L::And(mask, L::Gt(a, zero));
+				if (!L::Any(mask))
+					continue;
+
+				// GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA on all four channels
+				olc::Pixel* dst = row + x;
+				if (x + L::N > x1 + 1)
+				{
+					std::copy(dst, dst + (x1 + 1 - x), tail);
+					dst = tail;
+				}
+				const I d = L::Load(dst);
+				const F keep = L::Sub(one, a);
+				I out = L::Or(
+					L::Or(Blend<L>(r, a, keep, d, 0), L::Shl(Blend<L>(g, a, keep, d, 8), 8)),
+					L::Or(L::Shl(Blend<L>(b, a, keep, d, 16), 16), L::Shl(Blend<L>(L::Mul(a, full), a, keep, d, 24), 24)));
+				L::Store(dst, L::Select(mask, out, d));
+				if (dst == tail)
+					std::copy(tail, tail + (x1 + 1 - x), row + x);
+			}
+		}
+
+		static void ShadeSpanScalar(const SoftwareRasterizer::Triangle& t, int32_t y, int32_t x0, int32_t x1, olc::Pixel* row)
+		{ ShadeSpan<LanesScalar>(t, y, x0, x1, row); }
+
+	#if defined(__x86_64__) || defined(_M_X64)
+		static void ShadeSpanSSE2(const SoftwareRasterizer::Triangle& t, int32_t y, int32_t x0, int32_t x1, olc::Pixel* row)
+		{ ShadeSpan<LanesSSE2>(t, y, x0, x1, row); }
+
+		// Flattened so the whole span is compiled for AVX2, not just the helpers
+		OLC_TARGET_AVX2 OLC_FLATTEN static void ShadeSpanAVX2(const SoftwareRasterizer::Triangle& t, int32_t y, int32_t x0, int32_t x1, olc::Pixel* row)
+		{ ShadeSpan<LanesAVX2>(t, y, x0, x1, row); }
+	#endif
+	}
+
+	SoftwareRasterizer::Path SoftwareRasterizer::BestPath()
+	{
+	#if defined(__x86_64__) || defined(_M_X64)
+		#if defined(__GNUC__)
+			if (__builtin_cpu_supports("avx2")) return Path::AVX2;
+		#elif defined(_MSC_VER)
+			int info[4];
+			__cpuid(info, 1);
+			bool bOSSaves = (info[2] & (1 << 27)) != 0 && (_xgetbv(0) & 6) == 6;
+			__cpuidex(info, 7, 0);
+			if (bOSSaves && (info[1] & (1 << 5)) != 0) return Path::AVX2;
+		#endif
+		return Path::SSE2;
+	#else
+		return Path::SCALAR;
+	#endif
+	}
+
+	void SoftwareRasterizer::DrawQuad(const olc::DecalInstance& di, const Texture* tex, bool bVertexTint, Sampling sampling)
+	{
+		if (pTarget == nullptr) return;
+		if (tex != nullptr && (tex->vPixels.empty() || tex->width <= 0 || tex->height <= 0))
+			tex = nullptr;
+
+		Vertex v[4];
+		for (int i = 0; i < 4; i++)
+		{
+			// Textured decals were only ever tinted by their first corner
+			const olc::Pixel& tint = di.tint[bVertexTint ? i : 0];
+			v[i] = { { (di.pos[i].x + 1.0f) * 0.5f * pTarget->width, (1.0f - di.pos[i].y) * 0.5f * pTarget->height },
+				di.uv[i].x, di.uv[i].y, di.w[i], { tint.r / 255.0f, tint.g / 255.0f, tint.b / 255.0f, tint.a / 255.0f } };
+		}
+		AddTriangle(v[0], v[1], v[2], tex, sampling);
+		AddTriangle(v[0], v[2], v[3], tex, sampling);
+		if (tex != nullptr && !Uses(tex))
+			vTextures.push_back(tex);
+	}
+
+	void SoftwareRasterizer::AddTriangle(const Vertex& a, Vertex b, Vertex c, const Texture* tex, Sampling sampling)
+	{
+		auto cross = [](const olc::vf2d& p0, const olc::vf2d& p1, const olc::vf2d& p)
+		{ return (p1.x - p0.x) * (p.y - p0.y) - (p1.y - p0.y) * (p.x - p0.x); };
+
+		float fArea = cross(a.pos, b.pos, c.pos);
+		if (fArea == 0.0f || std::isnan(fArea)) return;
+		if (fArea < 0.0f)
+		{
+			std::swap(b, c);
+			fArea = -fArea;
+		}
+
+		Triangle t;
+		t.x0 = std::max(0, int32_t(std::floor(std::min({ a.pos.x, b.pos.x, c.pos.x }))));
+		t.y0 = std::max(0, int32_t(std::floor(std::min({ a.pos.y, b.pos.y, c.pos.y }))));
+		t.x1 = std::min(pTarget->width - 1, int32_t(std::ceil(std::max({ a.pos.x, b.pos.x, c.pos.x }))));
+		t.y1 = std::min(pTarget->height - 1, int32_t(std::ceil(std::max({ a.pos.y, b.pos.y, c.pos.y }))));
+		if (t.x0 > t.x1 || t.y0 > t.y1) return;
+
+		// Each edge is measured from its upper endpoint, so the triangle on the other side of a
+		// shared edge gets exactly the negated values and a pixel on it is only drawn once
+		const Vertex* ends[3][2] = { { &b, &c }, { &c, &a }, { &a, &b } };
+		for (int i = 0; i < 3; i++)
+		{
+			const olc::vf2d& p0 = ends[i][0]->pos;
+			const olc::vf2d& p1 = ends[i][1]->pos;
+			const olc::vf2d& o = (p0.y < p1.y || (p0.y == p1.y && p0.x < p1.x)) ? p0 : p1;
+			t.edges[i] = { -(p1.y - p0.y), p1.x - p0.x, o.x, o.y, (p0.y == p1.y && p1.x > p0.x) || p1.y < p0.y };
+		}
+
+		// Attributes from barycentric weights, the weight of a vertex is the edge opposite it over the area
+		auto plane = [&](float fa, float fb, float fc)
+		{
+			Plane p;
+			p.dx = (fa * t.edges[0].A + fb * t.edges[1].A + fc * t.edges[2].A) / fArea;
+			p.dy = (fa * t.edges[0].B + fb * t.edges[1].B + fc * t.edges[2].B) / fArea;
+			float fOrigin = 0.0f;
+			const float f[3] = { fa, fb, fc };
+			for (int i = 0; i < 3; i++)
+				fOrigin += f[i] * (-t.edges[i].A * t.edges[i].ox - t.edges[i].B * t.edges[i].oy);
+			p.c = fOrigin / fArea;
+			return p;
+		};
+
+		t.bPerspective = !(a.w == b.w && b.w == c.w);
+		if (t.bPerspective)
+		{
+			t.u = plane(a.u, b.u, c.u);
+			t.v = plane(a.v, b.v, c.v);
+			t.w = plane(a.w, b.w, c.w);
+		}
+		else
+		{
+			t.u = plane(a.u / a.w, b.u / b.w, c.u / c.w);
+			t.v = plane(a.v / a.w, b.v / b.w, c.v / c.w);
+			t.w = { 0.0f, 0.0f, 1.0f };
+		}
+
+		t.bConstantTint = std::equal(a.tint, a.tint + 4, b.tint) && std::equal(a.tint, a.tint + 4, c.tint);
+		for (int i = 0; i < 4; i++)
+			t.tint[i] = t.bConstantTint ? Plane{ 0.0f, 0.0f, a.tint[i] } : plane(a.tint[i], b.tint[i], c.tint[i]);
+
+		t.tex = tex;
+		t.sampling = sampling;
+		vTriangles.push_back(t);
+	}
+
+	void SoftwareRasterizer::Flush()
+	{
+		if (vTriangles.empty() || pTarget == nullptr)
+		{
+			vTriangles.clear();
+			vTextures.clear();
+			return;
+		}
+
+		// Every thread takes its own rows and draws all the triangles over them in order
+		int nBands = std::min(nThreads, std::max(1, pTarget->height / 16));
+		if (nBands == 1)
+			DrawRows(0, pTarget->height - 1);
+		else
+		{
+			std::vector<std::thread> vWorkers;
+			int32_t nRows = (pTarget->height + nBands - 1) / nBands;
+			for (int i = 1; i < nBands; i++)
+				vWorkers.emplace_back(&SoftwareRasterizer::DrawRows, this, i * nRows, std::min(pTarget->height, (i + 1) * nRows) - 1);
+			DrawRows(0, nRows - 1);
+			for (auto& w : vWorkers)
+				w.join();
+		}
+		vTriangles.clear();
+		vTextures.clear();
+	}
+
+	void SoftwareRasterizer::DrawRows(int32_t y0, int32_t y1)
+	{
+		auto shade = raster::ShadeSpanScalar;
+	#if defined(__x86_64__) || defined(_M_X64)
+		if (path == Path::SSE2) shade = raster::ShadeSpanSSE2;
+		if (path == Path::AVX2) shade = raster::ShadeSpanAVX2;
+	#endif
+
+		for (const Triangle& t : vTriangles)
+		{
+			for (int32_t y = std::max(y0, t.y0); y <= std::min(y1, t.y1); y++)
+			{
+				// Narrow the row down to where every edge can be positive, give or take a pixel,
+				// the exact test is done per pixel
+				const float py = float(y) + 0.5f;
+				float fLeft = float(t.x0), fRight = float(t.x1);
+				for (const Edge& e : t.edges)
+				{
+					float fValue = e.A * (0.5f - e.ox) + e.B * (py - e.oy);
+					if (e.A > 0.0f) fLeft = std::max(fLeft, std::floor(-fValue / e.A) - 1.0f);
+					else if (e.A < 0.0f) fRight = std::min(fRight, std::ceil(-fValue / e.A) + 1.0f);
+					else if (e.B * (py - e.oy) < 0.0f) fRight = fLeft - 1.0f;
+				}
+				if (fLeft <= fRight)
+					shade(t, y, int32_t(fLeft), int32_t(fRight), pTarget->GetData() + size_t(y) * pTarget->width);
+			}
+		}
+	}
+
+	// Keeps track of what would have been drawn. With headless.bRasterize the
+	// textures are kept and every quad is drawn into headless.pFrame in software
+	class Renderer_Headless : public olc::Renderer
+	{
+	private:
+		typedef SoftwareRasterizer::Texture Texture;
+		std::map<uint32_t, Texture> mapTextures;
+		uint32_t nNextTexture = 1;
+		uint32_t nAppliedTexture = 0;
+		uint32_t nBatchTexture = 0;
+		bool bBatchPending = false;
+		SoftwareRasterizer rasterizer;
+
+	public:
+		void PrepareDevice() override
+		{ }
+
+		olc::rcode CreateDevice(std::vector<void*> params, bool bFullScreen, bool bVSYNC) override
+		{ return olc::rcode::OK; }
+
+		olc::rcode DestroyDevice() override
+		{
+			rasterizer.SetTarget(nullptr);
+			mapTextures.clear();
+			return olc::rcode::OK;
+		}
+
+		void DisplayFrame() override
+		{ rasterizer.Flush(); }
+
+		void PrepareDrawing() override
+		{ }
+
+		void DrawLayerQuad(const olc::vf2d& offset, const olc::vf2d& scale, const olc::Pixel tint) override
+		{
+			headless.current.nLayerQuads++;
+			headless.current.nDrawCalls++;
+			if (!headless.bRasterize) return;
+
+			// The same corners and texture coordinates Renderer_OGL10 uses
+			olc::DecalInstance di;
+			di.pos[0] = { -1.0f, -1.0f }; di.pos[1] = { -1.0f, 1.0f }; di.pos[2] = { 1.0f, 1.0f }; di.pos[3] = { 1.0f, -1.0f };
+			di.uv[0] = { offset.x, scale.y + offset.y }; di.uv[1] = { offset.x, offset.y };
+			di.uv[2] = { scale.x + offset.x, offset.y }; di.uv[3] = { scale.x + offset.x, scale.y + offset.y };
+			for (auto& t : di.tint) t = tint;
+			rasterizer.DrawQuad(di, FindTexture(nAppliedTexture), false);
+		}
+
+		void DrawDecalQuad(const olc::DecalInstance& decal) override
+		{
+			uint32_t id = decal.decal == nullptr ? 0 : decal.decal->id;
+			if (id != nBatchTexture)
+			{
+				FlushDecalQuads();
+				nBatchTexture = id;
+			}
+			bBatchPending = true;
+			headless.current.nDecalQuads++;
+
+			if (headless.bRasterize)
+				rasterizer.DrawQuad(decal, FindTexture(id), decal.decal == nullptr);
+		}
+
+		void FlushDecalQuads() override
+		{
+			if (bBatchPending)
+				headless.current.nDrawCalls++;
+			bBatchPending = false;
+		}
+
+		uint32_t CreateTexture(const uint32_t width, const uint32_t height) override
+		{
+			uint32_t id = nNextTexture++;
+			mapTextures[id] = Texture();
+			return id;
+		}
+
+		uint32_t DeleteTexture(const uint32_t id) override
+		{
+			if (rasterizer.Uses(FindTexture(id)))
+				rasterizer.Flush();
+			mapTextures.erase(id);
+			return id;
+		}
+
+		void UpdateTexture(uint32_t id, olc::Sprite* spr) override
+		{
+			headless.current.nUploadedBytes += size_t(spr->width) * spr->height * sizeof(olc::Pixel);
+			if (!headless.bRasterize) return;
+
+			Texture& tex = mapTextures[id];
+			if (rasterizer.Uses(&tex))
+				rasterizer.Flush();
+			tex.width = spr->width;
+			tex.height = spr->height;
+			tex.vPixels.assign(spr->GetData(), spr->GetData() + size_t(spr->width) * spr->height);
+		}
+
+		void UpdateTextureRegions(uint32_t id, olc::Sprite* spr, const std::vector<std::pair<olc::vi2d, olc::vi2d>>& vRects) override
+		{
+			for (auto& rect : vRects)
+				headless.current.nUploadedBytes += size_t(rect.second.x) * rect.second.y * sizeof(olc::Pixel);
+			if (!headless.bRasterize || vRects.empty()) return;
+
+			Texture& tex = mapTextures[id];
+			if (tex.width != spr->width || tex.height != spr->height)
+			{
+				UpdateTexture(id, spr);
+				return;
+			}
+			if (rasterizer.Uses(&tex))
+				rasterizer.Flush();
+			for (auto& rect : vRects)
+				for (int32_t y = rect.first.y; y < rect.first.y + rect.second.y; y++)
+				{
+					const olc::Pixel* src = spr->GetData() + size_t(y) * spr->width + rect.first.x;
+					std::copy(src, src + rect.second.x, tex.vPixels.begin() + size_t(y) * tex.width + rect.first.x);
+				}
+		}
+
+		// Nothing is streamed, regions are copied straight into the texture
+		void SetPixelBuffers(uint32_t, bool) override { }
+
+		void ApplyTexture(uint32_t id) override
+		{ nAppliedTexture = id; }
+
+		void UpdateViewport(const olc::vi2d& pos, const olc::vi2d& size) override
+		{
+			if (!headless.bRasterize || size.x <= 0 || size.y <= 0) return;
+			if (!headless.pFrame || headless.pFrame->width != size.x || headless.pFrame->height != size.y)
+			{
+				rasterizer.SetTarget(nullptr);
+				headless.pFrame = std::make_unique<olc::Sprite>(size.x, size.y);
+			}
+			rasterizer.SetTarget(headless.pFrame.get());
+			rasterizer.SetThreads(headless.nRasterThreads);
+		}
+
+		void ClearBuffer(olc::Pixel p, bool bDepth) override
+		{
+			rasterizer.Flush();
+			if (headless.bRasterize && headless.pFrame)
+				std::fill(headless.pFrame->GetData(), headless.pFrame->GetData() + headless.pFrame->width * headless.pFrame->height, p);
+		}
+
+	private:
+		const Texture* FindTexture(uint32_t id) const
+		{
+			auto it = mapTextures.find(id);
+			return it == mapTextures.end() ? nullptr : &it->second;
+		}
+	};
+
+	// No window, the engine thread runs until headless.nFrames have been drawn.
+	// The real time every frame took and what it submitted end up in headless.vFrames
+	class Platform_Headless : public olc::Platform
+	{
+	private:
+		std::chrono::steady_clock::time_point tpFrame;
+		uint32_t nFrame = 0;
+
+	public:
+		virtual olc::rcode ApplicationStartUp() override
+		{
+			headless.vFrames.clear();
+			headless.vFrames.reserve(headless.nFrames);
+			headless.current = HeadlessFrame();
+			return olc::rcode::OK;
+		}
+
+		virtual olc::rcode ApplicationCleanUp() override
+		{ return olc::rcode::OK; }
+
+		virtual olc::rcode ThreadStartUp() override
+		{ return olc::rcode::OK; }
+
+		virtual olc::rcode ThreadCleanUp() override
+		{
+			FinishFrame();
+			renderer->DestroyDevice();
+			return olc::OK;
+		}
+
+		virtual olc::rcode CreateGraphics(bool bFullScreen, bool bEnableVSYNC, const olc::vi2d& vViewPos, const olc::vi2d& vViewSize) override
+		{
+			ptrPGE->SetFixedElapsedTime(headless.fElapsedTime);
+			renderer->CreateDevice({}, bFullScreen, bEnableVSYNC);
+			renderer->UpdateViewport(vViewPos, vViewSize);
+			return olc::rcode::OK;
+		}
+
+		virtual olc::rcode CreateWindowPane(const olc::vi2d& vWindowPos, olc::vi2d& vWindowSize, bool bFullScreen) override
+		{
+			ptrPGE->olc_UpdateKeyFocus(true);
+			ptrPGE->olc_UpdateMouseFocus(true);
+			return olc::rcode::OK;
+		}
+
+		virtual olc::rcode SetWindowTitle(const std::string& s) override
+		{ return olc::rcode::OK; }
+
+		virtual olc::rcode StartSystemEventLoop() override
+		{ return olc::rcode::OK; }
+
+		virtual olc::rcode HandleSystemEvent() override
+		{
+			FinishFrame();
+			if (headless.nFrames > 0 && nFrame >= headless.nFrames)
+			{
+				// Let this frame run out, the engine stops before the next one
+				ptrPGE->olc_Terminate();
+				return olc::rcode::OK;
+			}
+
+			if (headless.funcInput)
+				headless.funcInput(ptrPGE, nFrame);
+			nFrame++;
+			tpFrame = std::chrono::steady_clock::now();
+			return olc::rcode::OK;
+		}
+
+	private:
+		void FinishFrame()
+		{
+			if (nFrame == 0 || headless.vFrames.size() == nFrame) return;
+			headless.current.fTime = std::chrono::duration<float>(std::chrono::steady_clock::now() - tpFrame).count();
+			headless.vFrames.push_back(headless.current);
+			headless.current = HeadlessFrame();
+		}
+	};
+}
+#endif
+// O------------------------------------------------------------------------------O
+// | END PLATFORM & RENDERER: HEADLESS                                            |
+// O------------------------------------------------------------------------------O
+
+
 namespace olc
 {
 	void PixelGameEngine::olc_ConfigureSystem()
 	{
+#if defined(OLC_PGE_HEADLESS)
+		platform = std::make_unique<olc::Platform_Headless>();
+		renderer = std::make_unique<olc::Renderer_Headless>();
+#else
 #if defined(_WIN32)
 		platform = std::make_unique<olc::Platform_Windows>();
 #endif
@@ -3365,6 +4674,7 @@ namespace olc
 
 #if defined(OLC_GFX_DIRECTX10)
 		renderer = std::make_unique<olc::Renderer_DX10>();
+#endif
 #endif
 
 		//// Associate components with PGE instance